@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "pacman_sim.h"
+#include "pacman_map.h"
+#include "actors.h"
+#include "ghost_ai.h"
+#include "alloc_counter.h"
+
+// Runs many coroutine ghosts (ghost_ai.h) on the classic board and reports
+// the cost per actor per tick and how many actors each tick had to resume.
+// Build with -DPACMAN_COUNT_ALLOCS to have every steady-state tick checked
+// for heap allocations.
+//
+// Usage: actor_bench [--actors N] [--ticks T] [--seed S]
+
+int main(int argc, char *argv[]) {
+    int actorCount = 20000;
+    int ticks = 2000;
+    std::uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--actors") == 0 && hasValue) actorCount = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) ticks = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Unknown or incomplete option " << argv[i] << std::endl;
+            return -1;
+        }
+    }
+
+    // Only the maze itself; the open space right of it would make every
+    // cell a junction
+    GameRules rules;
+    rules.columns = MAZE_WIDTH;
+    SimState state = loadSimState(CLASSIC_MAP, rules);
+    for (const auto &spawn : CLASSIC_GHOSTS) addSimGhost(state, spawn.x, spawn.y, spawn.number);
+    int houseExitX, houseExitY;
+    findHouseExit(CLASSIC_MAP, houseExitX, houseExitY);
+    GhostWorld world;
+    world.build(state, houseExitX, houseExitY);
+
+    // Spawn everyone on random open cells, a quarter of them on cells that
+    // classicGhost counts as inside the house
+    std::vector<std::pair<int, int>> open, house;
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        for (int x = 0; x < MAP_WIDTH; ++x) {
+            if (!isWalkable(state, x, y)) continue;
+            open.emplace_back(x, y);
+            if (world.houseExitX >= 0 && world.exitDistance[y][x] <= GHOST_HOUSE_RADIUS) house.emplace_back(x, y);
+        }
+    }
+    if (house.empty()) house = open;
+    SimRng rng(seed);
+    ActorScheduler scheduler(static_cast<std::size_t>(actorCount), world.exits);
+    auto spawnStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < actorCount; ++i) {
+        const auto &cells = i % 4 == 0 ? house : open;
+        auto cell = cells[rng.next() % cells.size()];
+        Actor *actor = scheduler.create(cell.first, cell.second, static_cast<char>('1' + i % 4));
+        actor->seed = seed + static_cast<std::uint64_t>(i);
+        scheduler.start(*actor, classicGhost(*actor, world));
+    }
+    double spawnSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - spawnStart).count();
+
+    // Pacman wanders so the chase targets keep changing; a power pellet
+    // every 200 ticks exercises frightened mode
+    AllocationGuard tickGuard("actor tick");
+    Direction pacmanDirection = Direction::Right;
+    std::uint64_t resumesBefore = scheduler.resumes();
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        tickGuard.begin();
+        if (t % 8 == 0) pacmanDirection = static_cast<Direction>(rng.next() & 3);
+        stepPacman(state, pacmanDirection, rules);
+        world.pacmanX = state.pacmanX;
+        world.pacmanY = state.pacmanY;
+        world.pacmanDirection = pacmanDirection;
+        if (t % 200 == 100) {
+            world.frightenedSince = scheduler.now() + 1;
+            world.frightenedUntil = scheduler.now() + 1 + GameRules().powerTicks;
+        }
+        scheduler.tick();
+        tickGuard.end();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::uint64_t resumes = scheduler.resumes() - resumesBefore;
+
+    const ActorFramePool &pool = scheduler.pool();
+    std::cout << actorCount << " actors x " << ticks << " ticks: " << seconds / ticks * 1e3 << " ms/tick, "
+              << seconds * 1e9 / (static_cast<double>(ticks) * actorCount) << " ns per actor-tick, "
+              << static_cast<double>(resumes) / ticks << " resumes/tick ("
+              << 100.0 * resumes / (static_cast<double>(ticks) * actorCount) << "% of actors)" << std::endl;
+    std::cout << "spawn " << spawnSeconds * 1e9 / actorCount << " ns/actor, frame pool " << pool.chunks()
+              << " chunks for " << pool.liveFrames() << " frames, " << pool.oversizedFrames() << " oversized" << std::endl;
+    return 0;
+}
@@ -0,0 +1,363 @@
+#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "pacman_sim.h"
+
+// Actors whose logic is a C++20 coroutine. An actor's body is ordinary
+// sequential code that suspends with
+//
+//   co_await self.tick();       // run again next tick
+//   co_await self.junction();   // keep cruising, run again at the next junction or dead end
+//   co_await self.sleep(n);     // stand still, run again n ticks from now
+//
+// ActorScheduler::tick() resumes only the actors that are due: everyone
+// waiting for the next tick, sleepers whose timer expired and cruisers that
+// reached a decision cell. Cruisers are otherwise moved along their
+// corridor without resuming them. Coroutine frames come from a pooled
+// allocator owned by the scheduler, so once the pool is warm spawning,
+// resuming and destroying actors does not touch the heap.
+
+// Fixed size classes of frame blocks carved from large chunks. Freed blocks
+// go on a per-class free list and are reused by the next frame of that size.
+class ActorFramePool {
+public:
+    static constexpr std::size_t GRANULE = 64;
+    static constexpr std::size_t CLASSES = 16;       // Blocks up to 1 KB
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    ActorFramePool() = default;
+    ActorFramePool(const ActorFramePool &) = delete;
+    ActorFramePool &operator=(const ActorFramePool &) = delete;
+
+    void *allocate(std::size_t size) {
+        std::size_t sizeClass = (size + GRANULE - 1) / GRANULE;
+        if (sizeClass == 0 || sizeClass > CLASSES) {
+            oversized_++;
+            return ::operator new(size);
+        }
+        live_++;
+        FreeBlock *&head = freeLists_[sizeClass - 1];
+        if (head) {
+            FreeBlock *block = head;
+            head = block->next;
+            return block;
+        }
+        std::size_t bytes = sizeClass * GRANULE;
+        if (chunkUsed_ + bytes > CHUNK_SIZE || chunks_.empty()) {
+            chunks_.emplace_back(new unsigned char[CHUNK_SIZE]);
+            chunkUsed_ = 0;
+        }
+        void *block = chunks_.back().get() + chunkUsed_;
+        chunkUsed_ += bytes;
+        return block;
+    }
+
+    void deallocate(void *pointer, std::size_t size) {
+        std::size_t sizeClass = (size + GRANULE - 1) / GRANULE;
+        if (sizeClass == 0 || sizeClass > CLASSES) {
+            ::operator delete(pointer);
+            return;
+        }
+        live_--;
+        FreeBlock *block = static_cast<FreeBlock *>(pointer);
+        block->next = freeLists_[sizeClass - 1];
+        freeLists_[sizeClass - 1] = block;
+    }
+
+    std::size_t chunks() const { return chunks_.size(); }
+    std::size_t liveFrames() const { return live_; }
+    std::size_t oversizedFrames() const { return oversized_; }
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    FreeBlock *freeLists_[CLASSES] = {};
+    std::vector<std::unique_ptr<unsigned char[]>> chunks_;
+    std::size_t chunkUsed_ = 0;
+    std::size_t live_ = 0;
+    std::size_t oversized_ = 0;
+};
+
+class ActorScheduler;
+struct Actor;
+
+// Return type of an actor body. The first parameter of every actor body
+// must be the Actor it drives; the frame is allocated from that actor's
+// scheduler pool.
+struct ActorTask {
+    struct promise_type {
+        // Room in front of the frame for the pool that owns it
+        static constexpr std::size_t HEADER = alignof(std::max_align_t);
+
+        template <typename... Args>
+        static void *operator new(std::size_t size, Actor &self, Args &...);
+
+        static void operator delete(void *frame, std::size_t size) {
+            unsigned char *block = static_cast<unsigned char *>(frame) - HEADER;
+            ActorFramePool *pool = *reinterpret_cast<ActorFramePool **>(block);
+            pool->deallocate(block, size + HEADER);
+        }
+
+        ActorTask get_return_object() { return ActorTask{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+enum class ActorWait : std::uint8_t { Start, Tick, Junction, Sleep, Done };
+
+// Per-actor state, also the handle an actor body uses to talk to the
+// scheduler. Lives in the scheduler's fixed table, so references to it stay
+// valid for the actor's lifetime.
+struct Actor {
+    struct Await {
+        Actor &actor;
+        ActorWait wait;
+        std::uint32_t ticks;
+
+        bool await_ready() const noexcept { return wait == ActorWait::Sleep && ticks == 0; }
+        void await_suspend(std::coroutine_handle<>) noexcept;
+        void await_resume() const noexcept {}
+    };
+
+    Await tick() { return Await{*this, ActorWait::Tick, 0}; }
+    Await junction() { return Await{*this, ActorWait::Junction, 0}; }
+    Await sleep(std::uint32_t ticks) { return Await{*this, ActorWait::Sleep, ticks}; }
+
+    std::uint32_t now() const;
+    const ExitMasks &exits() const;
+
+    // Open directions from the current cell, optionally excluding the way back
+    std::uint8_t options(bool allowReverse = false) const {
+        std::uint8_t mask = exits()[y][x];
+        if (!allowReverse && direction != Direction::Stay) mask &= ~EXIT_BIT[static_cast<int>(reverseOf(direction))];
+        return mask ? mask : exits()[y][x];
+    }
+
+    static Direction reverseOf(Direction direction) {
+        switch (direction) {
+            case Direction::Up: return Direction::Down;
+            case Direction::Down: return Direction::Up;
+            case Direction::Left: return Direction::Right;
+            case Direction::Right: return Direction::Left;
+            default: return Direction::Stay;
+        }
+    }
+
+    std::int16_t x = 0, y = 0;
+    Direction direction = Direction::Stay;
+    ActorWait wait = ActorWait::Start;
+    char tag = 0;                 // Free for the caller, e.g. the ghost number
+    std::uint32_t wakeTick = 0;
+    std::uint64_t seed = 0;       // Free for the body, e.g. to key an RNG
+    ActorScheduler *scheduler = nullptr;
+    ActorFramePool *pool = nullptr;
+    std::coroutine_handle<ActorTask::promise_type> body;
+};
+
+template <typename... Args>
+void *ActorTask::promise_type::operator new(std::size_t size, Actor &self, Args &...) {
+    unsigned char *block = static_cast<unsigned char *>(self.pool->allocate(size + HEADER));
+    *reinterpret_cast<ActorFramePool **>(block) = self.pool;
+    return block + HEADER;
+}
+
+class ActorScheduler {
+public:
+    // capacity is fixed up front: actors never move, and the wait lists
+    // are sized so scheduling never reallocates
+    ActorScheduler(std::size_t capacity, const ExitMasks &exits) : exits_(&exits), actors_(capacity) {
+        ready_.reserve(capacity);
+        nextReady_.reserve(capacity);
+        sleepers_.reserve(capacity);
+        free_.reserve(capacity);
+        for (std::size_t i = capacity; i > 0; --i) free_.push_back(static_cast<int>(i - 1));
+    }
+
+    ~ActorScheduler() { clear(); }
+
+    ActorScheduler(const ActorScheduler &) = delete;
+    ActorScheduler &operator=(const ActorScheduler &) = delete;
+
+    // Reserves an actor slot at (x, y); start() must then attach its body.
+    // Returns nullptr when the scheduler is full.
+    Actor *create(int x, int y, char tag = 0) {
+        if (free_.empty()) return nullptr;
+        Actor &actor = actors_[free_.back()];
+        free_.pop_back();
+        actor = Actor();
+        actor.x = static_cast<std::int16_t>(x);
+        actor.y = static_cast<std::int16_t>(y);
+        actor.tag = tag;
+        actor.scheduler = this;
+        actor.pool = &pool_;
+        return &actor;
+    }
+
+    // The body runs up to its first co_await on the next tick
+    void start(Actor &actor, ActorTask task) {
+        actor.body = task.handle;
+        actor.wait = ActorWait::Tick;
+        nextReady_.push_back(indexOf(actor));
+        live_++;
+    }
+
+    // Destroys every actor; their frames go back to the pool
+    void clear() {
+        free_.clear();
+        for (std::size_t i = actors_.size(); i > 0; --i) {
+            Actor &actor = actors_[i - 1];
+            if (actor.body) actor.body.destroy();
+            actor = Actor();
+            free_.push_back(static_cast<int>(i - 1));
+        }
+        ready_.clear();
+        nextReady_.clear();
+        sleepers_.clear();
+        live_ = 0;
+    }
+
+    void setExits(const ExitMasks &exits) { exits_ = &exits; }
+
+    // One tick: wake everyone that is due, then move everyone that is not
+    // asleep one cell
+    void tick() {
+        now_++;
+
+        // Sleepers whose timer ran out join this tick's ready list
+        while (!sleepers_.empty() && sleepers_.front().wakeTick <= now_) {
+            std::pop_heap(sleepers_.begin(), sleepers_.end(), SleeperLater());
+            nextReady_.push_back(sleepers_.back().actor);
+            sleepers_.pop_back();
+        }
+
+        ready_.swap(nextReady_);
+        nextReady_.clear();
+        for (int index : ready_) {
+            Actor &actor = actors_[index];
+            actor.body.resume();
+            resumes_++;
+            if (actor.body.done()) {
+                // Finished bodies free their slot right away
+                actor.body.destroy();
+                actor = Actor();
+                actor.wait = ActorWait::Done;
+                free_.push_back(index);
+                live_--;
+            }
+        }
+
+        for (Actor &actor : actors_) {
+            if (actor.wait == ActorWait::Tick) {
+                step(actor, actor.direction);
+            } else if (actor.wait == ActorWait::Junction) {
+                cruise(actor);
+            }
+        }
+    }
+
+    std::uint32_t now() const { return now_; }
+    const ExitMasks &exits() const { return *exits_; }
+    std::size_t capacity() const { return actors_.size(); }
+    std::size_t live() const { return live_; }
+    std::uint64_t resumes() const { return resumes_; }
+    const ActorFramePool &pool() const { return pool_; }
+
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const Actor &actor : actors_) {
+            if (actor.body) visit(actor);
+        }
+    }
+
+private:
+    friend struct Actor;
+
+    struct Sleeper {
+        std::uint32_t wakeTick;
+        int actor;
+    };
+
+    struct SleeperLater {
+        bool operator()(const Sleeper &a, const Sleeper &b) const { return a.wakeTick > b.wakeTick; }
+    };
+
+    int indexOf(const Actor &actor) const { return static_cast<int>(&actor - actors_.data()); }
+
+    void park(Actor &actor, ActorWait wait, std::uint32_t ticks) {
+        actor.wait = wait;
+        switch (wait) {
+            case ActorWait::Tick:
+                nextReady_.push_back(indexOf(actor));
+                break;
+            case ActorWait::Sleep:
+                actor.wakeTick = now_ + ticks;
+                sleepers_.push_back(Sleeper{actor.wakeTick, indexOf(actor)});
+                std::push_heap(sleepers_.begin(), sleepers_.end(), SleeperLater());
+                break;
+            default:
+                break;
+        }
+    }
+
+    bool step(Actor &actor, Direction direction) {
+        if (direction == Direction::Stay || !(exits()[actor.y][actor.x] & EXIT_BIT[static_cast<int>(direction)])) return false;
+        actor.x = static_cast<std::int16_t>(actor.x + DIRECTION_DX[static_cast<int>(direction)]);
+        actor.y = static_cast<std::int16_t>(actor.y + DIRECTION_DY[static_cast<int>(direction)]);
+        actor.direction = direction;
+        return true;
+    }
+
+    // Follows the corridor: straight on, or round the only bend. Once the
+    // actor stands on a cell with a real choice (or a dead end) it is woken
+    // next tick to decide.
+    void cruise(Actor &actor) {
+        Direction direction = actor.direction;
+        if (direction == Direction::Stay || !(exits()[actor.y][actor.x] & EXIT_BIT[static_cast<int>(direction)])) {
+            direction = firstExit(actor.options());
+        }
+        step(actor, direction);
+
+        // An actor that could not move at all (no exits) is woken as well
+        std::uint8_t ahead = exits()[actor.y][actor.x];
+        if (actor.direction != Direction::Stay) ahead &= ~EXIT_BIT[static_cast<int>(Actor::reverseOf(actor.direction))];
+        if (actor.direction == Direction::Stay || exitCount(ahead) != 1) {
+            actor.wait = ActorWait::Tick;
+            nextReady_.push_back(indexOf(actor));
+        }
+    }
+
+    static Direction firstExit(std::uint8_t mask) {
+        for (int d = 0; d < 4; ++d) {
+            if (mask & EXIT_BIT[d]) return static_cast<Direction>(d);
+        }
+        return Direction::Stay;
+    }
+
+    const ExitMasks *exits_;
+    std::vector<Actor> actors_;
+    std::vector<int> ready_, nextReady_, free_;
+    std::vector<Sleeper> sleepers_; // Min-heap on wakeTick
+    ActorFramePool pool_;
+    std::uint32_t now_ = 0;
+    std::size_t live_ = 0;
+    std::uint64_t resumes_ = 0;
+};
+
+inline void Actor::Await::await_suspend(std::coroutine_handle<>) noexcept { actor.scheduler->park(actor, wait, ticks); }
+inline std::uint32_t Actor::now() const { return scheduler->now(); }
+inline const ExitMasks &Actor::exits() const { return scheduler->exits(); }
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Debug allocation counter. Build with -DPACMAN_COUNT_ALLOCS to replace the
+// global operator new/delete with versions that count allocations per
+// thread; without it every call here compiles down to nothing. The
+// replacements are ordinary definitions, so include this header with the
+// flag set from exactly one translation unit (the game's main file).
+// check_allocs.sh builds stress this way and soaks every policy.
+
+#ifdef PACMAN_COUNT_ALLOCS
+
+inline thread_local std::uint64_t threadAllocations = 0;
+
+inline std::uint64_t threadAllocationCount() { return threadAllocations; }
+
+// Every replacement below allocates and frees through these two, so
+// over-aligned requests (alignas(64) levels, trace rings) are counted like
+// any other. Freeing sits behind a call GCC cannot see into, so it does not
+// mistake free() for a mismatch with operator new (-Wmismatched-new-delete).
+inline void *countedAllocate(std::size_t size, std::size_t alignment) noexcept {
+    threadAllocations++;
+    if (size == 0) size = 1;
+    if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+[[gnu::noinline]] inline void countedFree(void *memory) noexcept { std::free(memory); }
+
+inline void *countedAllocateOrThrow(std::size_t size, std::size_t alignment) {
+    if (void *memory = countedAllocate(size, alignment)) return memory;
+    throw std::bad_alloc();
+}
+
+constexpr std::size_t DEFAULT_NEW_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+void *operator new(std::size_t size) { return countedAllocateOrThrow(size, DEFAULT_NEW_ALIGNMENT); }
+void *operator new[](std::size_t size) { return countedAllocateOrThrow(size, DEFAULT_NEW_ALIGNMENT); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return countedAllocate(size, DEFAULT_NEW_ALIGNMENT); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return countedAllocate(size, DEFAULT_NEW_ALIGNMENT); }
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *memory) noexcept { countedFree(memory); }
+void operator delete[](void *memory) noexcept { countedFree(memory); }
+void operator delete(void *memory, std::size_t) noexcept { countedFree(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { countedFree(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { countedFree(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { countedFree(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { countedFree(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { countedFree(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { countedFree(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { countedFree(memory); }
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept { countedFree(memory); }
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept { countedFree(memory); }
+
+#else
+
+inline std::uint64_t threadAllocationCount() { return 0; }
+
+#endif
+
+// Fails loudly when a loop that should be allocation-free touches the heap.
+// Call begin() at the top of an iteration and end() at the bottom; the
+// first warmupIterations are ignored so one-off setup (first draw, lazy
+// SFML state) is not reported.
+class AllocationGuard {
+public:
+    AllocationGuard(const char *name, int warmupIterations = 10) : name_(name), warmup_(warmupIterations) {}
+
+    void begin() { start_ = threadAllocationCount(); }
+
+    void end() {
+        std::uint64_t count = threadAllocationCount() - start_;
+        if (iteration_++ < warmup_ || count == 0) return;
+        std::fprintf(stderr, "%s allocated %llu time(s) in steady-state iteration %llu\n", name_,
+                     static_cast<unsigned long long>(count), static_cast<unsigned long long>(iteration_));
+        std::abort();
+    }
+
+private:
+    const char *name_;
+    std::uint64_t warmup_;
+    std::uint64_t iteration_ = 0;
+    std::uint64_t start_ = 0;
+};
@@ -0,0 +1,320 @@
+#pragma once
+
+#include "pacman_sim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct AutopilotConfig {
+    GameRules rules;                        // Rules the rollouts simulate
+    std::chrono::microseconds budget{5000}; // Search time per decision
+    int workers = 0;                        // 0 = one per hardware thread
+    int rolloutDepth = 12;                  // Ticks simulated after the root move
+    double exploration = 20.0;              // UCB1 constant, in score points
+    double discount = 0.97;                 // Later rewards count for less
+    double deathPenalty = 100.0;
+    double winBonus = 500.0;
+    double pelletDistanceWeight = 1.0;      // Pull towards food beyond the rollout horizon
+};
+
+struct AutopilotStats {
+    std::uint64_t decisions = 0;
+    std::uint64_t rollouts = 0;
+    std::uint64_t simulatedTicks = 0;
+    double searchSeconds = 0.0;
+
+    double rolloutsPerSecond() const { return searchSeconds > 0 ? rollouts / searchSeconds : 0.0; }
+    double ticksPerSecond() const { return searchSeconds > 0 ? simulatedTicks / searchSeconds : 0.0; }
+};
+
+// Root-parallel Monte Carlo search. Every worker runs UCB1 over the legal
+// first moves with random rollouts on its own copy of the state; the visit
+// counts and value sums are merged when the deadline passes. Workers are
+// started once and reused, and each one clones the root into a scratch
+// SimState it owns, so a decision does not touch the heap.
+class Autopilot {
+public:
+    explicit Autopilot(const AutopilotConfig &config = AutopilotConfig()) : config_(config) {
+        int count = config_.workers > 0 ? config_.workers : static_cast<int>(std::thread::hardware_concurrency());
+        count = std::max(count, 1);
+
+        std::random_device rd;
+        workers_.resize(count);
+        for (int i = 0; i < count; ++i) {
+            workers_[i].rng = SimRng((static_cast<std::uint64_t>(rd()) << 32) ^ rd() ^ (i + 1));
+        }
+        for (int i = 0; i < count; ++i) {
+            threads_.emplace_back(&Autopilot::workerLoop, this, i);
+        }
+    }
+
+    ~Autopilot() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto &thread : threads_) thread.join();
+    }
+
+    Autopilot(const Autopilot &) = delete;
+    Autopilot &operator=(const Autopilot &) = delete;
+
+    // Returns the best move for Pacman from the given state, or Direction::Stay
+    // if every neighbouring cell is a wall.
+    Direction chooseDirection(const SimState &state) {
+        auto start = std::chrono::steady_clock::now();
+
+        int legalCount = 0;
+        for (int d = 0; d < 4; ++d) {
+            if (isWalkable(state, state.pacmanX + DIRECTION_DX[d], state.pacmanY + DIRECTION_DY[d])) {
+                legal_[legalCount++] = static_cast<Direction>(d);
+            }
+        }
+        if (legalCount <= 1) {
+            return legalCount == 1 ? legal_[0] : Direction::Stay;
+        }
+
+        buildPelletDistances(state);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            root_ = state;
+            legalCount_ = legalCount;
+            deadline_ = start + config_.budget;
+            pending_ = static_cast<int>(workers_.size());
+            generation_++;
+        }
+        wake_.notify_all();
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return pending_ == 0; });
+        }
+
+        std::array<std::uint64_t, 4> visits{};
+        std::array<double, 4> values{};
+        for (auto &worker : workers_) {
+            for (int a = 0; a < legalCount; ++a) {
+                visits[a] += worker.visits[a];
+                values[a] += worker.values[a];
+            }
+            stats_.rollouts += worker.rollouts;
+            stats_.simulatedTicks += worker.ticks;
+        }
+
+        int best = 0;
+        double bestMean = -1e300;
+        for (int a = 0; a < legalCount; ++a) {
+            double mean = visits[a] ? values[a] / visits[a] - rootBias(state, legal_[a]) : -1e300;
+            if (mean > bestMean) {
+                bestMean = mean;
+                best = a;
+            }
+        }
+
+        stats_.decisions++;
+        stats_.searchSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return legal_[best];
+    }
+
+    const AutopilotStats &stats() const { return stats_; }
+    const AutopilotConfig &config() const { return config_; }
+
+private:
+    struct Worker {
+        SimState scratch;
+        SimRng rng;
+        std::array<std::uint64_t, 4> visits;
+        std::array<double, 4> values;
+        std::uint64_t rollouts;
+        std::uint64_t ticks;
+    };
+
+    void workerLoop(int index) {
+        Worker &worker = workers_[index];
+        std::uint64_t seen = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if (stopping_) return;
+                seen = generation_;
+            }
+
+            search(worker);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_--;
+            }
+            done_.notify_one();
+        }
+    }
+
+    void search(Worker &worker) {
+        worker.visits.fill(0);
+        worker.values.fill(0.0);
+        worker.rollouts = 0;
+        worker.ticks = 0;
+
+        std::uint64_t total = 0;
+        do {
+            int action = 0;
+            double bestScore = -1e300;
+            for (int a = 0; a < legalCount_; ++a) {
+                if (worker.visits[a] == 0) {
+                    action = a;
+                    break;
+                }
+                double mean = worker.values[a] / worker.visits[a] - rootBias(root_, legal_[a]);
+                double ucb = mean + config_.exploration * std::sqrt(std::log(static_cast<double>(total)) / worker.visits[a]);
+                if (ucb > bestScore) {
+                    bestScore = ucb;
+                    action = a;
+                }
+            }
+
+            worker.scratch = root_;
+            double reward = rollout(worker, legal_[action]);
+            worker.visits[action]++;
+            worker.values[action] += reward;
+            worker.rollouts++;
+            total++;
+        } while (std::chrono::steady_clock::now() < deadline_);
+    }
+
+    // Plays the root move, then follows the rollout policy for the configured
+    // depth and returns the discounted score change.
+    double rollout(Worker &worker, Direction first) {
+        SimState &state = worker.scratch;
+        Direction direction = first;
+        double weight = 1.0;
+        double reward = 0.0;
+        // Each rollout sees its own ghost moves
+        std::uint64_t ghostKey = (static_cast<std::uint64_t>(worker.rng.next()) << 32) | worker.rng.next();
+
+        for (int t = 0; t <= config_.rolloutDepth; ++t) {
+            if (t > 0) direction = pickRolloutDirection(state, direction, worker.rng);
+
+            int score = state.score;
+            int lives = state.lives;
+            stepSimState(state, direction, ghostKey, config_.rules);
+            worker.ticks++;
+
+            reward += weight * (state.score - score);
+            if (state.lives < lives) {
+                return reward - weight * config_.deathPenalty;
+            }
+            if (state.pellets == 0) {
+                return reward + weight * config_.winBonus;
+            }
+            weight *= config_.discount;
+        }
+        return reward;
+    }
+
+    // Rollouts rarely tell two exits apart when the nearest food is beyond the
+    // horizon, so every root move is also charged for its distance to food.
+    double rootBias(const SimState &state, Direction direction) const {
+        int x = state.pacmanX + DIRECTION_DX[static_cast<int>(direction)];
+        int y = state.pacmanY + DIRECTION_DY[static_cast<int>(direction)];
+        return config_.pelletDistanceWeight * pelletDistance_[y][x];
+    }
+
+    // Breadth-first distance from every cell to the nearest pellet on the root
+    // board, using fixed member buffers so it stays off the heap.
+    void buildPelletDistances(const SimState &state) {
+        int head = 0, tail = 0;
+        for (int y = 0; y < MAP_HEIGHT; ++y) {
+            for (int x = 0; x < MAP_WIDTH; ++x) {
+                CellType cell = state.board[y][x];
+                bool pellet = cell == CellType::Pellet || cell == CellType::PowerPellet;
+                pelletDistance_[y][x] = pellet ? 0 : UNREACHED;
+                if (pellet) bfsQueue_[tail++] = y * MAP_WIDTH + x;
+            }
+        }
+        while (head < tail) {
+            int index = bfsQueue_[head++];
+            int x = index % MAP_WIDTH, y = index / MAP_WIDTH;
+            for (int d = 0; d < 4; ++d) {
+                int nx = x + DIRECTION_DX[d], ny = y + DIRECTION_DY[d];
+                if (isWalkable(state, nx, ny) && pelletDistance_[ny][nx] == UNREACHED) {
+                    pelletDistance_[ny][nx] = pelletDistance_[y][x] + 1;
+                    bfsQueue_[tail++] = ny * MAP_WIDTH + nx;
+                }
+            }
+        }
+        for (auto &row : pelletDistance_) {
+            for (auto &distance : row) {
+                if (distance == UNREACHED) distance = 0;
+            }
+        }
+    }
+
+    // Mostly greedy towards food: a neighbouring pellet first, otherwise the
+    // exit closest to a pellet on the root board. One move in four is random
+    // so the rollouts still spread out. Pacman never reverses unless stuck.
+    Direction pickRolloutDirection(const SimState &state, Direction current, SimRng &rng) const {
+        static constexpr Direction reverse[5] = {Direction::Down, Direction::Up, Direction::Right, Direction::Left, Direction::Stay};
+
+        Direction options[4];
+        int count = 0;
+        for (int d = 0; d < 4; ++d) {
+            Direction candidate = static_cast<Direction>(d);
+            if (candidate == reverse[static_cast<int>(current)]) continue;
+            if (isWalkable(state, state.pacmanX + DIRECTION_DX[d], state.pacmanY + DIRECTION_DY[d])) {
+                options[count++] = candidate;
+            }
+        }
+        if (count == 0) return reverse[static_cast<int>(current)]; // Dead end, turn around
+
+        std::uint32_t roll = rng.next();
+        if (count == 1 || (roll & 3) == 0) return options[(roll >> 2) % count];
+
+        Direction best = options[0];
+        int bestCost = 1 << 30;
+        for (int i = 0; i < count; ++i) {
+            int x = state.pacmanX + DIRECTION_DX[static_cast<int>(options[i])];
+            int y = state.pacmanY + DIRECTION_DY[static_cast<int>(options[i])];
+            CellType cell = state.board[y][x];
+            int cost = (cell == CellType::Pellet || cell == CellType::PowerPellet) ? -1 : pelletDistance_[y][x];
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = options[i];
+            }
+        }
+        return best;
+    }
+
+    AutopilotConfig config_;
+    AutopilotStats stats_;
+
+    std::vector<Worker> workers_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    bool stopping_ = false;
+    std::uint64_t generation_ = 0;
+    int pending_ = 0;
+
+    // Written by chooseDirection before a generation starts, read-only while workers run
+    SimState root_{};
+    std::array<Direction, 4> legal_{};
+    int legalCount_ = 0;
+    std::chrono::steady_clock::time_point deadline_;
+
+    static constexpr int UNREACHED = -1;
+    std::array<std::array<int, MAP_WIDTH>, MAP_HEIGHT> pelletDistance_{};
+    std::array<int, MAP_WIDTH * MAP_HEIGHT> bfsQueue_{};
+};
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Hot-path allocation check. Builds stress with -DPACMAN_COUNT_ALLOCS, so
+# alloc_counter.h counts every heap allocation per thread, and soaks every
+# threading policy with scripted input, with rendering and with random
+# input through the input thread. AllocationGuard aborts the run the first
+# time a steady-state tick or frame allocates, so any failure here is a
+# heap allocation on a hot path.
+#
+# Usage: ./check_allocs.sh [GAMES]   (default 10; CXX picks the compiler)
+
+set -eu
+cd "$(dirname "$0")"
+
+games=${1:-10}
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+${CXX:-g++} -std=c++20 -O2 -Wall -Wextra -pthread -DPACMAN_COUNT_ALLOCS stress.cpp -o "$dir/stress"
+
+for policy in single split job; do
+    for mode in "" --render --random; do
+        echo "stress --policy $policy${mode:+ $mode}"
+        if ! "$dir/stress" --games "$games" --policy $policy $mode; then
+            echo "check_allocs: stress --policy $policy${mode:+ $mode} failed" >&2
+            exit 1
+        fi
+    done
+done
+echo "check_allocs: no hot-path allocations"
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Counter-based random numbers. A value is a pure function of a 64-bit key
+// and a 128-bit counter, so there is no generator state to share, lock or
+// carry around: any thread can draw the value of any actor at any tick in
+// any order and always gets the same number. The counter is laid out as
+//
+//   (tick, actor, purpose, index)
+//
+// so each actor has an independent stream per tick and per use, and a
+// simulation is reproducible from its seed alone.
+//
+// The mixing function is Philox4x32-10 (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3", SC'11), which produces four 32-bit words
+// per counter value.
+
+using RandomBlock = std::array<std::uint32_t, 4>;
+
+inline RandomBlock philox4x32(RandomBlock counter, std::uint64_t key) {
+    constexpr std::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    constexpr std::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+    std::uint32_t k0 = static_cast<std::uint32_t>(key), k1 = static_cast<std::uint32_t>(key >> 32);
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t p0 = static_cast<std::uint64_t>(M0) * counter[0];
+        std::uint64_t p1 = static_cast<std::uint64_t>(M1) * counter[2];
+        counter = {static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ k0, static_cast<std::uint32_t>(p1),
+                   static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ k1, static_cast<std::uint32_t>(p0)};
+        k0 += W0;
+        k1 += W1;
+    }
+    return counter;
+}
+
+// What a draw is for, so two uses at the same tick never share a value
+enum class RandomPurpose : std::uint32_t { GhostTurn, GhostFlee, Rollout, Script, Key };
+
+// The one value an actor draws for a purpose at a tick
+inline std::uint32_t counterRandom(std::uint64_t key, std::uint32_t tick, std::uint32_t actor, RandomPurpose purpose) {
+    return philox4x32({tick, actor, static_cast<std::uint32_t>(purpose), 0}, key)[0];
+}
+
+// counterRandom for actors firstActor .. firstActor + count - 1 at once.
+// The blocks are independent, so the loop pipelines (and vectorises where
+// the compiler manages to).
+inline void fillRandom(std::uint64_t key, std::uint32_t tick, RandomPurpose purpose, std::uint32_t firstActor,
+                       std::uint32_t *out, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = philox4x32({tick, firstActor + static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(purpose), 0}, key)[0];
+    }
+}
+
+// A new key for a sub-simulation (a game, a rollout, an actor body), so
+// their streams do not overlap with the parent's
+inline std::uint64_t deriveRandomKey(std::uint64_t key, std::uint32_t a, std::uint32_t b = 0) {
+    RandomBlock block = philox4x32({a, b, static_cast<std::uint32_t>(RandomPurpose::Key), 0}, key);
+    return (static_cast<std::uint64_t>(block[1]) << 32) | block[0];
+}
+
+// Uniform in [0, n) from one 32-bit draw by multiply-shift, with no
+// rejection loop; the bias is below n / 2^32
+inline std::uint32_t randomBelow(std::uint32_t bits, std::uint32_t n) {
+    return static_cast<std::uint32_t>((static_cast<std::uint64_t>(bits) * n) >> 32);
+}
+
+// Sequential stream for code that needs an unknown number of draws, e.g. a
+// rollout. Draws come four at a time from consecutive counter indices, so
+// (key, tick, actor, purpose) still fully determines every value.
+class CounterRng {
+public:
+    CounterRng(std::uint64_t key = 0, std::uint32_t tick = 0, std::uint32_t actor = 0,
+               RandomPurpose purpose = RandomPurpose::Rollout)
+        : key_(key), counter_{tick, actor, static_cast<std::uint32_t>(purpose), 0} {}
+
+    std::uint32_t next() {
+        if (lane_ == 4) {
+            block_ = philox4x32(counter_, key_);
+            counter_[3]++;
+            lane_ = 0;
+        }
+        return block_[lane_++];
+    }
+
+    void fill(std::uint32_t *out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) out[i] = next();
+    }
+
+private:
+    std::uint64_t key_;
+    RandomBlock counter_;
+    RandomBlock block_{};
+    int lane_ = 4;
+};
@@ -0,0 +1,752 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pacman_sim.h"
+#include "pacman_map.h"
+#include "autopilot.h"
+#include "mazegen.h"
+#include "frame_arena.h"
+#include "alloc_counter.h"
+#include "level_pack.h"
+#include "trace.h"
+#include "thread_sched.h"
+#include "ghost_ai.h"
+#include "frame_capture.h"
+
+// Game engine shared by every build. The rules live in pacman_sim.h, the
+// window/drawing side lives in a frontend, and how input, simulation and
+// rendering are spread over threads is a compile-time policy:
+//
+//   Engine<SingleThreaded>  one loop does input, one tick and one frame
+//   Engine<SplitThreads>    input, simulation and rendering threads sharing
+//                           the state under gameBoardMutex
+//   Engine<JobThreads>      each tick is a job on a one-thread pool while the
+//                           calling thread draws the previous tick
+//
+// A frontend is any class with these members (see sfml_frontend.h and
+// headless_frontend.h):
+//   bool open();                                   // on the render thread
+//   bool isOpen() const;
+//   void processEvents(InputState &input);         // on the render thread
+//   void pollInput(InputState &input, const SimState &view); // any thread
+//   void draw(const GameSnapshot &snapshot);       // on the render thread
+//   void present();
+//   void finish(const GameSnapshot &snapshot, bool gameEnded);
+// Frontends that can record also take an EngineConfig::capture through
+// record() before open(); present() then hands each frame to the writer.
+
+using EngineClock = std::chrono::steady_clock;
+
+struct EngineConfig {
+    std::array<std::string, MAP_HEIGHT> map = CLASSIC_MAP;
+    std::vector<GhostSpawn> ghosts;  // Added on top of any '1'-'9' in the map
+    GameRules rules;
+    int tickMilliseconds = 200;      // Simulation period; 0 runs as fast as possible
+    int frameMilliseconds = 200;     // Render period of policies with their own render loop
+    int inputMilliseconds = 100;     // Input polling period of SplitThreads
+    bool autopilot = false;          // Search-based controller replaces the player
+    AutopilotConfig autopilotConfig;
+    std::uint64_t seed = 0;          // Ghost RNG seed; 0 = random
+    std::uint64_t maxTicks = 0;      // Stop after this many ticks; 0 = until the game ends
+    std::uint64_t maxGames = 0;      // With restartOnFinish, stop after this many finished games
+    bool restartOnFinish = false;    // Start a new game instead of stopping
+    bool checkInvariants = false;    // Verify the state after every tick and abort on a violation
+    bool ghostActors = false;        // Scatter/chase/frightened coroutine ghosts instead of the random walk
+    bool scriptedInput = false;      // Each tick steps scriptedDirection(scriptSeed, tick), ignoring the controls
+    std::uint64_t scriptSeed = 0;
+    // Levels from a compiled pack replace map and ghosts. Clearing one moves
+    // on to the next with score and lives kept. The pack must have been
+    // compiled with the same columns and pellets rules; opening checks it.
+    std::shared_ptr<const LevelPack> levelPack;
+    int firstLevel = 0;
+    std::string tracePath;           // Chrome trace-event JSON written after the run
+    SchedulingConfig scheduling;     // CPU pinning, SCHED_FIFO, deadline pacing, jitter report
+    CaptureConfig capture;           // Frames to record; frontends pick this up via record()
+};
+
+// splitmix64 finaliser, also usable as a stateless hash
+inline std::uint64_t splitMix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Direction a scripted run holds at a given tick. It is looked up for the
+// tick being stepped, on the thread that steps it, so it only depends on
+// the seed and the tick and every policy plays the same game.
+inline Direction scriptedDirection(std::uint64_t seed, std::uint32_t tick) {
+    return static_cast<Direction>(splitMix64(seed + tick / 8) & 3);
+}
+
+// Shared between whoever reads the controls and whoever runs the tick
+struct InputState {
+    std::atomic<Direction> held{Direction::Right};    // Last direction, used every tick
+    std::atomic<Direction> pressed{Direction::Stay};  // One-step move, consumed by the next tick
+    std::atomic<bool> quit{false};
+
+    void press(Direction direction) {
+        held = direction;
+        pressed = direction;
+    }
+};
+
+// What a frontend draws: the state after a tick and when the input that
+// produced that tick was read, so present() can report step-to-present
+// latency
+struct GameSnapshot {
+    SimState state;
+    EngineClock::time_point sampledAt;
+};
+
+// Replace the map with a generated maze that fits the playfield and put all
+// ghosts on its spawn cell
+inline void loadGeneratedMaze(EngineConfig &config, std::uint32_t seed) {
+    MazeOptions options;
+    options.width = MAZE_WIDTH;
+    options.height = MAP_HEIGHT - 1;
+    options.seed = seed;
+    GeneratedMaze maze = generateMaze(options);
+
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        std::string row = y < maze.height ? maze.rows[y] : std::string();
+        row.resize(MAP_WIDTH, ' ');
+        config.map[y] = row;
+    }
+    for (auto &ghost : config.ghosts) {
+        ghost.x = maze.ghostX;
+        ghost.y = maze.ghostY;
+    }
+    std::cout << "Generated maze with seed " << seed << ", " << maze.pellets << " pellets" << std::endl;
+}
+
+// Fills the sim, render and input fields of a placement from "a,b,c"
+inline void parsePlacementList(const char *list, int ThreadPlacement::*field, SchedulingConfig &scheduling, int unset) {
+    ThreadPlacement *placements[3] = {&scheduling.sim, &scheduling.render, &scheduling.input};
+    for (ThreadPlacement *placement : placements) {
+        char *end;
+        long value = std::strtol(list, &end, 10);
+        placement->*field = end == list ? unset : static_cast<int>(value);
+        list = *end == ',' ? end + 1 : end;
+    }
+}
+
+// Options every build understands:
+//   --autopilot [ms]  let the search controller play, optional per-decision budget
+//   --maze [seed]     play a generated maze instead of the built-in map
+//   --seed N          fixed seed for the ghosts
+//   --pack FILE       play the levels of a pack built by levelc
+//   --level N         start at level N of the pack
+//   --ghost-ai        ghosts scatter, chase and flee instead of wandering at random
+//   --trace FILE      record a timeline of the threads (open in ui.perfetto.dev)
+//   --pin S,R,I       pin the sim, render and input threads to these CPUs (empty = any)
+//   --fifo S,R,I      SCHED_FIFO priorities for the same threads (0 = normal)
+//   --abs-deadlines   pace ticks on a fixed grid with clock_nanosleep(TIMER_ABSTIME) instead of
+//                     one period after the last wake-up; see PeriodPacer for overruns
+//   --jitter          report how late each tick started against its schedule
+//   --record FILE     record the presented frames to FILE as raw RGB24 video
+//   --record-ppm DIR  record them as DIR/frame_00000.ppm, ... instead
+//   --record-every K  only record every K-th frame
+//   --record-queue N  frames buffered for the recording writer (default 8)
+//   --record-block    wait for the writer when the buffers are full instead of dropping
+inline bool parseEngineOptions(int argc, char *argv[], EngineConfig &config) {
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc && argv[i + 1][0] != '-';
+        if (std::strcmp(argv[i], "--autopilot") == 0) {
+            config.autopilot = true;
+            if (hasValue) {
+                config.autopilotConfig.budget = std::chrono::microseconds(static_cast<long>(std::atof(argv[++i]) * 1000));
+            }
+        } else if (std::strcmp(argv[i], "--maze") == 0) {
+            std::uint32_t seed = hasValue ? static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10)) : std::random_device()();
+            loadGeneratedMaze(config, seed);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--pack") == 0 && hasValue) {
+            auto pack = std::make_shared<LevelPack>();
+            if (!pack->open(argv[++i], config.rules)) return false;
+            config.levelPack = pack;
+        } else if (std::strcmp(argv[i], "--level") == 0 && hasValue) {
+            config.firstLevel = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ghost-ai") == 0) {
+            config.ghostActors = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) {
+            config.tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--pin") == 0 && hasValue) {
+            parsePlacementList(argv[++i], &ThreadPlacement::cpu, config.scheduling, -1);
+        } else if (std::strcmp(argv[i], "--fifo") == 0 && hasValue) {
+            parsePlacementList(argv[++i], &ThreadPlacement::fifoPriority, config.scheduling, 0);
+        } else if (std::strcmp(argv[i], "--abs-deadlines") == 0) {
+            config.scheduling.absoluteDeadlines = true;
+        } else if (std::strcmp(argv[i], "--jitter") == 0) {
+            config.scheduling.jitterReport = true;
+        } else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+            config.capture.rawPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--record-ppm") == 0 && hasValue) {
+            config.capture.ppmDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--record-every") == 0 && hasValue) {
+            config.capture.every = std::max(std::atoi(argv[++i]), 1);
+        } else if (std::strcmp(argv[i], "--record-queue") == 0 && hasValue) {
+            config.capture.queueFrames = std::max(std::atoi(argv[++i]), 1);
+        } else if (std::strcmp(argv[i], "--record-block") == 0) {
+            config.capture.blockWhenFull = true;
+        } else {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    if (config.levelPack && (config.firstLevel < 0 || config.firstLevel >= config.levelPack->size())) {
+        std::cerr << "Level " << config.firstLevel << " is not in the pack (" << config.levelPack->size() << " levels)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// One running game: the state, its ghost random key and the input feeding it. It
+// does no locking of its own; the threading policy decides who may call
+// what and when.
+class GameSession {
+public:
+    explicit GameSession(const EngineConfig &config) : config_(config), seed_(config.seed ? config.seed : randomSeed()) {
+        if (config_.autopilot) {
+            AutopilotConfig autopilotConfig = config_.autopilotConfig;
+            autopilotConfig.rules = config_.rules;
+            autopilot_.reset(new Autopilot(autopilotConfig));
+        }
+        if (config_.levelPack) streamer_.reset(new LevelStreamer(*config_.levelPack));
+        if (config_.scheduling.jitterReport) tickJitter_.reset(new JitterStats());
+        if (config_.ghostActors && config_.rules.ghostsMove) {
+            ghostDirector_.reset(new GhostDirector());
+            // The director moves the ghosts, so the plain step must not
+            directorRules_ = config_.rules;
+            directorRules_.ghostsMove = false;
+        }
+        reset();
+    }
+
+    ~GameSession() {
+        if (autopilot_) {
+            const AutopilotStats &stats = autopilot_->stats();
+            std::cout << "Autopilot: " << stats.decisions << " decisions, " << static_cast<long>(stats.rolloutsPerSecond())
+                      << " rollouts/s, " << static_cast<long>(stats.ticksPerSecond()) << " sim ticks/s" << std::endl;
+        }
+        if (tickJitter_) tickJitter_->print("Tick");
+        if (streamer_ && levelSwitches_ > 0) {
+            std::cout << "Levels: " << levelSwitches_ << " switches, slowest " << slowestLevelSwitch_ << " us, "
+                      << streamer_->hits() << " preloaded / " << streamer_->misses() << " read directly" << std::endl;
+        }
+    }
+
+    GameSession(const GameSession &) = delete;
+    GameSession &operator=(const GameSession &) = delete;
+
+    const EngineConfig &config() const { return config_; }
+    InputState &input() { return input_; }
+    const GameSnapshot &snapshot() const { return snapshot_; }
+
+    void reset() {
+        if (streamer_) {
+            loadLevel(config_.firstLevel);
+            snapshot_.state.lives = config_.rules.lives;
+        } else {
+            snapshot_.state = loadSimState(config_.map, config_.rules);
+            for (const auto &spawn : config_.ghosts) addSimGhost(snapshot_.state, spawn.x, spawn.y, spawn.number);
+        }
+        startBoard();
+        snapshot_.sampledAt = EngineClock::now();
+    }
+
+    // Lets the autopilot, if any, steer from the given view of the game
+    void updateInput(const SimState &view) {
+        if (!autopilot_) return;
+        TraceSpan span("autopilot");
+        Direction direction = autopilot_->chooseDirection(view);
+        if (direction != Direction::Stay) input_.press(direction);
+    }
+
+    Direction nextDirection() {
+        if (config_.scriptedInput) return scriptedDirection(config_.scriptSeed, snapshot_.state.tick);
+        return config_.rules.holdDirection ? input_.held.load() : input_.pressed.exchange(Direction::Stay);
+    }
+
+    // Advances one tick. sampledAt is when the input for this tick was read.
+    void step(Direction direction, EngineClock::time_point sampledAt) {
+        TraceSpan span("tick");
+        if (config_.checkInvariants) beforeStep_ = snapshot_.state;
+        if (ghostDirector_) {
+            stepSimState(snapshot_.state, direction, boardKey_, directorRules_);
+            ghostDirector_->tick(snapshot_.state, direction);
+        } else {
+            stepSimState(snapshot_.state, direction, boardKey_, config_.rules);
+        }
+        snapshot_.sampledAt = sampledAt;
+        ticks_++;
+        if (config_.checkInvariants) checkInvariants(direction);
+
+        bool ended = simFinished(snapshot_.state, config_.rules);
+        if (ended && snapshot_.state.lives > 0 && streamer_ && level_ + 1 < config_.levelPack->size()) {
+            nextLevel();
+            ended = false;
+        }
+        if (ended && config_.restartOnFinish) {
+            if (snapshot_.state.lives > 0) wins_++;
+            finishedGames_++;
+            games_++;
+            reset();
+            ended = false;
+        }
+        if (ended) gameEnded_ = true;
+        if (ended || (config_.maxTicks && ticks_ >= config_.maxTicks) || (config_.maxGames && finishedGames_ >= config_.maxGames)) {
+            finished_ = true;
+        }
+    }
+
+    // Safe to call from any thread
+    bool finished() const { return finished_ || input_.quit; }
+    bool gameEnded() const { return gameEnded_; }
+    std::uint64_t ticks() const { return ticks_; }
+    std::uint64_t games() const { return games_; }
+    std::uint64_t finishedGames() const { return finishedGames_; }
+    std::uint64_t wins() const { return wins_; }
+    int level() const { return level_; }
+
+    // Pacer for the loop that runs the ticks; it feeds the jitter report
+    PeriodPacer tickPacer() const {
+        return PeriodPacer(config_.tickMilliseconds, config_.scheduling.absoluteDeadlines, tickJitter_.get());
+    }
+
+    PeriodPacer pacer(int milliseconds) const {
+        return PeriodPacer(milliseconds, config_.scheduling.absoluteDeadlines);
+    }
+
+private:
+    static std::uint64_t randomSeed() {
+        std::random_device rd;
+        return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+    }
+
+    // Besides the state itself, replays the tick from the state before it:
+    // with the timers inside SimState the same snapshot, direction and key
+    // must give the same state. Actor ghosts keep state outside SimState, so
+    // that check only applies to the plain step.
+    void checkInvariants(Direction direction) {
+        const char *problem = checkSimInvariants(snapshot_.state, config_.rules);
+        if (!problem && !ghostDirector_) {
+            stepSimState(beforeStep_, direction, boardKey_, config_.rules);
+            if (!(beforeStep_ == snapshot_.state)) problem = "replaying the tick from its snapshot gave a different state";
+        }
+        if (!problem) return;
+        const SimState &state = snapshot_.state;
+        std::cerr << "Invariant violated after tick " << ticks_ << " (game " << games_ << ", tick " << state.tick
+                  << "): " << problem << ". Pacman at " << state.pacmanX << "," << state.pacmanY << ", pellets "
+                  << state.pellets << ", lives " << state.lives << ", score " << state.score << std::endl;
+        std::abort();
+    }
+
+    // Takes the level from the streamer, which starts on the one after it
+    // (or on the first one again after the last, for a restart)
+    void loadLevel(int index) {
+        level_ = index;
+        streamer_->take(index, snapshot_.state, levelExits_);
+        streamer_->request(index + 1 < config_.levelPack->size() ? index + 1 : config_.firstLevel);
+    }
+
+    // Every board (new game or next level) gets its own random key, so the
+    // ghosts of one game do not replay the moves of the last. Packs carry no
+    // map sketch, so their ghosts have no house to leave, but they do carry
+    // the exit masks the ghosts steer by.
+    void startBoard() {
+        boardKey_ = deriveRandomKey(seed_, static_cast<std::uint32_t>(games_), static_cast<std::uint32_t>(level_));
+        if (!ghostDirector_) return;
+        int houseExitX = -1, houseExitY = -1;
+        if (!streamer_) findHouseExit(config_.map, houseExitX, houseExitY);
+        ghostDirector_->reset(snapshot_.state, houseExitX, houseExitY, boardKey_, streamer_ ? &levelExits_ : nullptr);
+    }
+
+    // Cleared a level: same score and lives on the next board
+    void nextLevel() {
+        auto start = EngineClock::now();
+        int score = snapshot_.state.score;
+        int lives = snapshot_.state.lives;
+        loadLevel(level_ + 1);
+        snapshot_.state.score = score;
+        snapshot_.state.lives = lives;
+        startBoard();
+
+        double micros = std::chrono::duration<double, std::micro>(EngineClock::now() - start).count();
+        slowestLevelSwitch_ = std::max(slowestLevelSwitch_, micros);
+        levelSwitches_++;
+    }
+
+    EngineConfig config_;
+    InputState input_;
+    GameSnapshot snapshot_;
+    std::uint64_t seed_;
+    std::uint64_t boardKey_ = 0;     // Ghost randomness of the current board, see counter_rng.h
+    SimState beforeStep_{};          // With checkInvariants, the state the last tick started from
+    std::unique_ptr<Autopilot> autopilot_;
+    std::unique_ptr<LevelStreamer> streamer_;
+    ExitMasks levelExits_{};         // Of the current pack level, from the streamer
+    std::unique_ptr<JitterStats> tickJitter_;
+    std::unique_ptr<GhostDirector> ghostDirector_;
+    GameRules directorRules_;
+    int level_ = 0;
+    int levelSwitches_ = 0;
+    double slowestLevelSwitch_ = 0.0;
+    std::atomic<std::uint64_t> ticks_{0};
+    std::uint64_t games_ = 1;
+    std::atomic<std::uint64_t> finishedGames_{0};
+    std::uint64_t wins_ = 0;
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> gameEnded_{false};
+};
+
+// Transient data of one frame (a snapshot copy, a tick's job records) goes
+// in a FrameArena this big, reserved before the loop starts
+constexpr std::size_t FRAME_ARENA_BYTES = 4 * 1024;
+static_assert(sizeof(GameSnapshot) + alignof(GameSnapshot) <= FRAME_ARENA_BYTES, "a frame's snapshot copy must fit");
+
+constexpr LockTraceNames GAME_BOARD_LOCK_TRACE{"wait gameBoardMutex", "hold gameBoardMutex"};
+
+struct SingleThreaded {
+    template <typename Frontend>
+    static void run(GameSession &session, Frontend &frontend) {
+        if (!frontend.open()) return;
+        setTraceThreadName("mainThread");
+        applyThreadPlacement("mainThread", session.config().scheduling.sim);
+
+        AllocationGuard tickGuard("simulation tick");
+        AllocationGuard frameGuard("render frame");
+        PeriodPacer pacer = session.tickPacer();
+
+        while (frontend.isOpen() && !session.finished()) {
+            {
+                TraceSpan span("input");
+                frontend.processEvents(session.input());
+                frontend.pollInput(session.input(), session.snapshot().state);
+            }
+            session.updateInput(session.snapshot().state);
+
+            tickGuard.begin();
+            session.step(session.nextDirection(), EngineClock::now());
+            tickGuard.end();
+
+            frameGuard.begin();
+            {
+                TraceSpan span("draw");
+                frontend.draw(session.snapshot());
+            }
+            frameGuard.end();
+            {
+                TraceSpan span("present");
+                frontend.present();
+            }
+
+            pacer.wait();
+        }
+        frontend.finish(session.snapshot(), session.gameEnded());
+    }
+};
+
+template <typename Frontend>
+class SplitThreadsRun {
+public:
+    SplitThreadsRun(GameSession &session, Frontend &frontend) : session_(session), frontend_(frontend) {}
+
+    void run() {
+        // The window opens before the game starts ticking, so a slow open
+        // (e.g. allocating capture buffers) does not lose the first frames
+        if (!frontend_.open()) return;
+        std::thread inputThread(&SplitThreadsRun::inputHandlingThread, this);
+        std::thread gameStateThread(&SplitThreadsRun::gameStateUpdateThread, this);
+        renderingThread(); // The window stays on the calling thread
+
+        running_ = false;
+        inputThread.join();
+        gameStateThread.join();
+        frontend_.finish(session_.snapshot(), session_.gameEnded());
+    }
+
+private:
+    SimState copyState() {
+        TracedLock lock(gameBoardMutex_, GAME_BOARD_LOCK_TRACE);
+        return session_.snapshot().state;
+    }
+
+    void inputHandlingThread() {
+        setTraceThreadName("inputHandlingThread");
+        applyThreadPlacement("inputHandlingThread", session_.config().scheduling.input);
+        PeriodPacer pacer = session_.pacer(session_.config().inputMilliseconds);
+        while (running_) {
+            SimState view = copyState();
+            {
+                TraceSpan span("pollInput");
+                frontend_.pollInput(session_.input(), view);
+            }
+            session_.updateInput(view);
+
+            if (session_.config().inputMilliseconds > 0) {
+                pacer.wait();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void gameStateUpdateThread() {
+        setTraceThreadName("gameStateUpdateThread");
+        applyThreadPlacement("gameStateUpdateThread", session_.config().scheduling.sim);
+        AllocationGuard tickGuard("gameStateUpdateThread tick");
+        PeriodPacer pacer = session_.tickPacer();
+        while (running_) {
+            tickGuard.begin();
+            {
+                TracedLock lock(gameBoardMutex_, GAME_BOARD_LOCK_TRACE);
+                session_.step(session_.nextDirection(), EngineClock::now());
+            }
+            tickGuard.end();
+            if (session_.finished()) running_ = false;
+
+            if (session_.config().tickMilliseconds > 0) {
+                pacer.wait();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void renderingThread() {
+        setTraceThreadName("renderingThread");
+        applyThreadPlacement("renderingThread", session_.config().scheduling.render);
+
+        AllocationGuard frameGuard("renderingThread frame");
+        PeriodPacer pacer = session_.pacer(session_.config().frameMilliseconds);
+        while (running_ && frontend_.isOpen()) {
+            {
+                TraceSpan span("processEvents");
+                frontend_.processEvents(session_.input());
+            }
+            if (session_.finished()) break;
+
+            frameGuard.begin();
+            GameSnapshot *frame;
+            {
+                TracedLock lock(gameBoardMutex_, GAME_BOARD_LOCK_TRACE);
+                frame = frameArena_.create<GameSnapshot>(session_.snapshot());
+            }
+            {
+                TraceSpan span("draw");
+                frontend_.draw(*frame);
+            }
+            frameArena_.reset();
+            frameGuard.end();
+            {
+                TraceSpan span("present");
+                frontend_.present();
+            }
+
+            if (session_.config().frameMilliseconds > 0) {
+                pacer.wait();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    GameSession &session_;
+    Frontend &frontend_;
+    std::mutex gameBoardMutex_;
+    std::atomic<bool> running_{true};
+    FrameArena frameArena_{FRAME_ARENA_BYTES}; // Render thread's copy of each frame's snapshot
+};
+
+struct SplitThreads {
+    template <typename Frontend>
+    static void run(GameSession &session, Frontend &frontend) {
+        SplitThreadsRun<Frontend>(session, frontend).run();
+    }
+};
+
+// Fixed-size worker pool. Jobs are plain function pointers with a context
+// pointer, queued in a preallocated ring, so submitting one never allocates.
+class JobPool {
+public:
+    struct Job {
+        void (*run)(void *context);
+        void *context;
+        std::atomic<int> *pending; // Decremented when the job finishes
+    };
+
+    explicit JobPool(int workers, const ThreadPlacement &placement = ThreadPlacement()) : placement_(placement) {
+        workers = std::max(workers, 1);
+        for (int i = 0; i < workers; ++i) threads_.emplace_back(&JobPool::workerLoop, this);
+    }
+
+    ~JobPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto &thread : threads_) thread.join();
+    }
+
+    JobPool(const JobPool &) = delete;
+    JobPool &operator=(const JobPool &) = delete;
+
+    // Returns false when the queue is full; the caller then runs the job itself
+    bool submit(Job *job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tail_ - head_ == QUEUE_SIZE) return false;
+            queue_[tail_++ % QUEUE_SIZE] = job;
+        }
+        wake_.notify_one();
+        return true;
+    }
+
+    void wait(std::atomic<int> &pending) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&] { return pending.load() == 0; });
+    }
+
+private:
+    static constexpr std::size_t QUEUE_SIZE = 256;
+
+    void workerLoop() {
+        setTraceThreadName("jobWorker");
+        applyThreadPlacement("jobWorker", placement_);
+        while (true) {
+            Job *job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stopping_ || head_ != tail_; });
+                if (stopping_ && head_ == tail_) return;
+                job = queue_[head_++ % QUEUE_SIZE];
+            }
+            job->run(job->context);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                job->pending->fetch_sub(1);
+            }
+            done_.notify_all();
+        }
+    }
+
+    ThreadPlacement placement_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::array<Job *, QUEUE_SIZE> queue_{};
+    std::size_t head_ = 0, tail_ = 0;
+    bool stopping_ = false;
+};
+
+struct JobThreads {
+    struct TickContext {
+        GameSession *session;
+        const SimState *view;
+        EngineClock::time_point sampledAt;
+    };
+
+    template <typename Frontend>
+    static void run(GameSession &session, Frontend &frontend) {
+        if (!frontend.open()) return;
+        setTraceThreadName("mainThread");
+        applyThreadPlacement("mainThread", session.config().scheduling.render);
+
+        // Each tick steps from the one before, so only one is ever in
+        // flight and a second worker would never get a job
+        JobPool pool(1, session.config().scheduling.sim);
+        FrameArena frameArena(FRAME_ARENA_BYTES);
+
+        AllocationGuard frameGuard("job frame");
+        GameSnapshot frame = session.snapshot();
+        PeriodPacer pacer = session.tickPacer();
+
+        while (frontend.isOpen() && !session.finished()) {
+            {
+                TraceSpan span("input");
+                frontend.processEvents(session.input());
+                frontend.pollInput(session.input(), frame.state);
+            }
+
+            frameGuard.begin();
+
+            // Tick N runs on the pool while this thread draws tick N-1. Its
+            // records live in the frame arena until the end of the frame.
+            std::atomic<int> pending{1};
+            TickContext *context = frameArena.create<TickContext>(&session, &frame.state, EngineClock::now());
+            JobPool::Job *job = frameArena.create<JobPool::Job>(&runTick, context, &pending);
+            if (!pool.submit(job)) {
+                runTick(context);
+                pending = 0;
+            }
+
+            {
+                TraceSpan span("draw");
+                frontend.draw(frame);
+            }
+            {
+                TraceSpan span("wait tick");
+                pool.wait(pending);
+            }
+            frame = session.snapshot();
+
+            frameArena.reset();
+            frameGuard.end();
+            {
+                TraceSpan span("present");
+                frontend.present();
+            }
+
+            pacer.wait();
+        }
+        frontend.finish(session.snapshot(), session.gameEnded());
+    }
+
+    static void runTick(void *raw) {
+        auto *context = static_cast<TickContext *>(raw);
+        context->session->updateInput(*context->view);
+        context->session->step(context->session->nextDirection(), context->sampledAt);
+    }
+};
+
+template <typename ThreadingPolicy>
+class Engine {
+public:
+    explicit Engine(const EngineConfig &config) : session_(config) {}
+
+    template <typename Frontend>
+    void run(Frontend &frontend) {
+        const std::string &tracePath = session_.config().tracePath;
+        if (!tracePath.empty()) Tracer::instance().start();
+        ThreadingPolicy::run(session_, frontend);
+        if (!tracePath.empty()) {
+            Tracer::instance().stop();
+            if (!Tracer::instance().writeJson(tracePath)) std::cerr << "Failed to write trace " << tracePath << std::endl;
+        }
+    }
+
+    GameSession &session() { return session_; }
+
+private:
+    GameSession session_;
+};
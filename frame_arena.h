@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Bump allocator for data that only lives for one tick or one frame. All
+// memory comes from a single block reserved up front; allocate() just moves
+// an offset forward and reset() rewinds it, so nothing is freed one by one
+// and the steady-state loop never reaches the heap.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t capacity) : buffer_(new unsigned char[capacity]), capacity_(capacity) {}
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    // Returns nullptr when the arena is full; the miss is counted so the
+    // capacity can be raised instead of silently spilling to the heap.
+    void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        // Aligns the address, not the offset: the block itself is only
+        // aligned for max_align_t
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer_.get());
+        std::size_t start = ((base + offset_ + alignment - 1) & ~(alignment - 1)) - base;
+        if (start + size > capacity_) {
+            overflows_++;
+            return nullptr;
+        }
+        offset_ = start + size;
+        if (offset_ > highWater_) highWater_ = offset_;
+        return buffer_.get() + start;
+    }
+
+    // Constructs one object of a trivially destructible type, or returns
+    // nullptr when the arena is full
+    template <typename T, typename... Args>
+    T *create(Args &&...args) {
+        static_assert(std::is_trivially_destructible<T>::value, "reset() never runs destructors");
+        void *memory = allocate(sizeof(T), alignof(T));
+        return memory ? new (memory) T{std::forward<Args>(args)...} : nullptr;
+    }
+
+    void reset() { offset_ = 0; }
+
+    std::size_t used() const { return offset_; }
+    std::size_t capacity() const { return capacity_; }
+    std::size_t highWater() const { return highWater_; }
+    std::uint64_t overflows() const { return overflows_; }
+
+private:
+    std::unique_ptr<unsigned char[]> buffer_;
+    std::size_t capacity_;
+    std::size_t offset_ = 0;
+    std::size_t highWater_ = 0;
+    std::uint64_t overflows_ = 0;
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "soft_render.h"
+#include "trace.h"
+
+// Records frames for QA without holding up the thread that draws them.
+// A fixed pool of frame buffers is allocated up front; the render thread
+// takes a free one, fills it and queues it, and a writer thread streams the
+// queued frames to disk and hands the buffers back. When the writer falls
+// behind and no buffer is free the frame is either dropped or the render
+// thread waits, depending on blockWhenFull.
+
+struct CaptureConfig {
+    std::string rawPath;          // Append every captured frame to this file as RGB24
+    std::string ppmDir;           // Or write DIR/frame_00000.ppm, ... (DIR must exist)
+    int queueFrames = 8;          // Preallocated buffers between the renderer and the writer
+    int every = 1;                // Only capture every K-th frame
+    bool blockWhenFull = false;   // Wait for a free buffer instead of dropping the frame
+
+    bool enabled() const { return !rawPath.empty() || !ppmDir.empty(); }
+};
+
+struct CaptureStats {
+    std::uint64_t offered = 0;    // Frames presented while recording, captured or not
+    std::uint64_t captured = 0;   // Queued for the writer
+    std::uint64_t dropped = 0;    // No free buffer and not blocking
+    std::uint64_t written = 0;
+    std::uint64_t failed = 0;     // Writes that returned an error
+    double overheadMicros = 0.0;  // Render-thread time spent on captured frames, waits included
+    double maxOverheadMicros = 0.0;
+};
+
+class FrameCapture {
+public:
+    FrameCapture(const CaptureConfig &config, int width, int height) : config_(config) {
+        int count = std::max(config_.queueFrames, 1);
+        buffers_.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            buffers_.emplace_back(new Framebuffer(width, height));
+            free_.push_back(i);
+        }
+        frameNumbers_.assign(count, 0);
+        queued_.assign(count, -1);
+    }
+
+    // Flushes whatever is still queued before returning
+    ~FrameCapture() {
+        close();
+        printStats();
+    }
+
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+
+    bool open() {
+        if (!config_.rawPath.empty()) {
+            raw_ = std::fopen(config_.rawPath.c_str(), "wb");
+            if (!raw_) {
+                std::cerr << "Failed to open " << config_.rawPath << " for recording" << std::endl;
+                return false;
+            }
+        }
+        writer_ = std::thread(&FrameCapture::writerLoop, this);
+        return true;
+    }
+
+    void close() {
+        if (!writer_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        frameQueued_.notify_one();
+        writer_.join();
+        if (raw_) std::fclose(raw_);
+        raw_ = nullptr;
+    }
+
+    // Render thread: a buffer to fill for the next presented frame, or
+    // nullptr when this frame is skipped or dropped. Every non-null buffer
+    // must go back through submit(). The frame's overhead runs from
+    // startedAt, for callers whose capture work begins before acquire().
+    Framebuffer *acquire(std::chrono::steady_clock::time_point startedAt = std::chrono::steady_clock::now()) {
+        acquiredAt_ = startedAt;
+        std::uint64_t frame = frame_++;
+        std::unique_lock<std::mutex> lock(mutex_);
+        stats_.offered++;
+        if (frame % std::max(config_.every, 1) != 0) return nullptr;
+        if (free_.empty()) {
+            if (!config_.blockWhenFull) {
+                stats_.dropped++;
+                return nullptr;
+            }
+            TraceSpan span("capture wait");
+            bufferFreed_.wait(lock, [this] { return !free_.empty(); });
+        }
+        int index = free_.back();
+        free_.pop_back();
+        frameNumbers_[index] = frame;
+        return buffers_[index].get();
+    }
+
+    void submit(Framebuffer *buffer) {
+        int index = indexOf(buffer);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queued_[(queueHead_ + queueCount_) % queued_.size()] = index;
+            queueCount_++;
+            stats_.captured++;
+            addOverhead();
+        }
+        frameQueued_.notify_one();
+    }
+
+    // acquire(), copy, submit() for frames that already sit in memory
+    void capture(const Framebuffer &frame) {
+        Framebuffer *buffer = acquire();
+        if (!buffer) return;
+        std::copy(frame.pixels.begin(), frame.pixels.end(), buffer->pixels.begin());
+        submit(buffer);
+    }
+
+    CaptureStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void printStats() const {
+        CaptureStats stats = this->stats();
+        if (stats.offered == 0) return;
+        std::printf("Capture: %llu of %llu frames written, %llu dropped, %llu failed; overhead mean %.1f us, max %.1f us per captured frame\n",
+                    static_cast<unsigned long long>(stats.written), static_cast<unsigned long long>(stats.offered),
+                    static_cast<unsigned long long>(stats.dropped), static_cast<unsigned long long>(stats.failed),
+                    stats.captured ? stats.overheadMicros / stats.captured : 0.0, stats.maxOverheadMicros);
+    }
+
+private:
+    int indexOf(const Framebuffer *buffer) const {
+        for (std::size_t i = 0; i < buffers_.size(); ++i) {
+            if (buffers_[i].get() == buffer) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // Called with mutex_ held, at the end of the render thread's share
+    void addOverhead() {
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - acquiredAt_).count();
+        stats_.overheadMicros += micros;
+        stats_.maxOverheadMicros = std::max(stats_.maxOverheadMicros, micros);
+    }
+
+    void writerLoop() {
+        setTraceThreadName("capture");
+        char path[4096];
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            frameQueued_.wait(lock, [this] { return stopping_ || queueCount_ > 0; });
+            if (queueCount_ == 0) return;  // Stopping and drained
+            int index = queued_[queueHead_];
+            queueHead_ = (queueHead_ + 1) % queued_.size();
+            queueCount_--;
+            std::uint64_t frame = frameNumbers_[index];
+            lock.unlock();
+
+            bool ok = true;
+            {
+                TraceSpan span("write frame");
+                const Framebuffer &buffer = *buffers_[index];
+                if (!config_.ppmDir.empty()) {
+                    std::snprintf(path, sizeof(path), "%s/frame_%05llu.ppm", config_.ppmDir.c_str(),
+                                  static_cast<unsigned long long>(frame));
+                    ok = writePpm(buffer, path);
+                }
+                if (raw_) ok = writeRawFrame(buffer, raw_) && ok;
+            }
+
+            lock.lock();
+            if (ok) {
+                stats_.written++;
+            } else {
+                stats_.failed++;
+            }
+            free_.push_back(index);
+            bufferFreed_.notify_one();
+        }
+    }
+
+    CaptureConfig config_;
+    std::vector<std::unique_ptr<Framebuffer>> buffers_;
+    std::vector<std::uint64_t> frameNumbers_;  // Presented frame each buffer holds
+    std::FILE *raw_ = nullptr;
+
+    mutable std::mutex mutex_;
+    std::condition_variable frameQueued_;
+    std::condition_variable bufferFreed_;
+    std::vector<int> free_;
+    std::vector<int> queued_;                  // Ring of buffer indices, oldest at queueHead_
+    std::size_t queueHead_ = 0;
+    std::size_t queueCount_ = 0;
+    bool stopping_ = false;
+    CaptureStats stats_;
+
+    // Render thread only
+    std::uint64_t frame_ = 0;
+    std::chrono::steady_clock::time_point acquiredAt_{};
+
+    std::thread writer_;
+};
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "pacman_sim.h"
+#include "actors.h"
+
+// Classic ghost behaviour written as actor coroutines (actors.h): wait in
+// the ghost house, walk out through the '0' cell, then alternate scatter
+// and chase phases, fleeing at random while frightened. Targets are chased
+// the arcade way: at each junction take the exit whose next cell is closest
+// to the target, never turning straight back.
+
+constexpr std::uint32_t GHOST_RELEASE_TICKS = 12;   // Between one ghost leaving the house and the next
+constexpr std::uint32_t GHOST_SCATTER_TICKS = 35;
+constexpr std::uint32_t GHOST_CHASE_TICKS = 100;
+constexpr std::uint8_t GHOST_UNREACHABLE = 255;
+constexpr std::uint8_t GHOST_HOUSE_RADIUS = 6;      // Spawns this close to the exit count as inside the house
+
+// What the ghosts know about the level and about Pacman
+struct GhostWorld {
+    ExitMasks exits{};
+    std::array<std::array<std::uint8_t, MAP_WIDTH>, MAP_HEIGHT> exitDistance{}; // Steps to the house exit
+    int houseExitX = -1, houseExitY = -1;
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;     // Bounds of the open cells
+    int pacmanX = 0, pacmanY = 0;
+    Direction pacmanDirection = Direction::Right;
+    std::uint32_t frightenedUntil = 0;              // Scheduler tick frightened mode ends
+    std::uint32_t frightenedSince = 0;
+
+    // houseExitX < 0 means the level has no ghost house. Exit masks that
+    // came with the level (level packs) are used as they are.
+    void build(const SimState &state, int exitX, int exitY, const ExitMasks *levelExits = nullptr) {
+        if (levelExits) {
+            exits = *levelExits;
+        } else {
+            computeExitMasks(state, exits);
+        }
+        minX = MAP_WIDTH;
+        minY = MAP_HEIGHT;
+        maxX = maxY = 0;
+        for (int y = 0; y < MAP_HEIGHT; ++y) {
+            for (int x = 0; x < MAP_WIDTH; ++x) {
+                if (!isWalkable(state, x, y)) continue;
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+        }
+
+        houseExitX = exitX;
+        houseExitY = exitY;
+        for (auto &row : exitDistance) row.fill(GHOST_UNREACHABLE);
+        if (exitX < 0 || !isWalkable(state, exitX, exitY)) {
+            houseExitX = houseExitY = -1;
+            return;
+        }
+
+        // Breadth-first from the exit over a fixed queue
+        std::array<std::int16_t, MAP_WIDTH * MAP_HEIGHT> queue;
+        int head = 0, tail = 0;
+        exitDistance[exitY][exitX] = 0;
+        queue[tail++] = static_cast<std::int16_t>(exitY * MAP_WIDTH + exitX);
+        while (head < tail) {
+            int x = queue[head] % MAP_WIDTH, y = queue[head] / MAP_WIDTH;
+            head++;
+            for (int d = 0; d < 4; ++d) {
+                if (!(exits[y][x] & EXIT_BIT[d])) continue;
+                int nx = x + DIRECTION_DX[d], ny = y + DIRECTION_DY[d];
+                if (exitDistance[ny][nx] != GHOST_UNREACHABLE) continue;
+                exitDistance[ny][nx] = static_cast<std::uint8_t>(std::min<int>(exitDistance[y][x] + 1, GHOST_UNREACHABLE - 1));
+                queue[tail++] = static_cast<std::int16_t>(ny * MAP_WIDTH + nx);
+            }
+        }
+    }
+
+    bool frightened(std::uint32_t now) const { return now < frightenedUntil; }
+};
+
+// Exit from options whose next cell is closest to the target; ties go
+// Up, Left, Down, Right like the arcade
+inline Direction steerToward(const Actor &self, std::uint8_t options, int targetX, int targetY) {
+    static constexpr Direction ORDER[4] = {Direction::Up, Direction::Left, Direction::Down, Direction::Right};
+    Direction best = Direction::Stay;
+    long bestDistance = 0;
+    for (Direction direction : ORDER) {
+        int d = static_cast<int>(direction);
+        if (!(options & EXIT_BIT[d])) continue;
+        long dx = self.x + DIRECTION_DX[d] - targetX;
+        long dy = self.y + DIRECTION_DY[d] - targetY;
+        long distance = dx * dx + dy * dy;
+        if (best == Direction::Stay || distance < bestDistance) {
+            best = direction;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+// Scatter corners just outside the maze, one per personality
+inline void scatterTarget(const GhostWorld &world, int personality, int &x, int &y) {
+    x = personality == 0 || personality == 3 ? world.maxX + 2 : world.minX - 2;
+    y = personality < 2 ? world.minY - 3 : world.maxY + 2;
+}
+
+// '1' chases Pacman directly, '2' aims four cells ahead of him, '3' chases
+// only while far away and otherwise heads for its corner, '4' cuts him off
+// from two cells behind
+inline void chaseTarget(const GhostWorld &world, const Actor &self, int personality, int &x, int &y) {
+    int ahead = static_cast<int>(world.pacmanDirection);
+    int aheadX = ahead < 4 ? DIRECTION_DX[ahead] : 0, aheadY = ahead < 4 ? DIRECTION_DY[ahead] : 0;
+    x = world.pacmanX;
+    y = world.pacmanY;
+    switch (personality) {
+        case 1:
+            x += 4 * aheadX;
+            y += 4 * aheadY;
+            break;
+        case 2: {
+            int dx = self.x - world.pacmanX, dy = self.y - world.pacmanY;
+            if (dx * dx + dy * dy < 64) scatterTarget(world, personality, x, y);
+            break;
+        }
+        case 3:
+            x -= 2 * aheadX;
+            y -= 2 * aheadY;
+            break;
+        default:
+            break;
+    }
+}
+
+// One ghost from release to the end of the level. self.tag is the ghost
+// number, self.seed is the random key of its frightened walk; each turn is
+// the draw for the current tick (counter_rng.h).
+inline ActorTask classicGhost(Actor &self, const GhostWorld &world) {
+    const int personality = self.tag >= '1' ? (self.tag - '1') % 4 : 0;
+
+    // Ghosts that start in the house wait their turn, then walk down the
+    // distance field to its exit; the others set off straight away
+    bool inHouse = world.houseExitX >= 0 && world.exitDistance[self.y][self.x] <= GHOST_HOUSE_RADIUS;
+    if (inHouse) co_await self.sleep(GHOST_RELEASE_TICKS * personality);
+    while (inHouse && world.exitDistance[self.y][self.x] != 0) {
+        std::uint8_t here = world.exitDistance[self.y][self.x];
+        for (int d = 0; d < 4; ++d) {
+            if ((world.exits[self.y][self.x] & EXIT_BIT[d]) &&
+                world.exitDistance[self.y + DIRECTION_DY[d]][self.x + DIRECTION_DX[d]] < here) {
+                self.direction = static_cast<Direction>(d);
+                break;
+            }
+        }
+        co_await self.tick();
+    }
+
+    std::uint32_t frightenedSeen = 0;
+    for (bool chase = false, first = true;; chase = !chase, first = false) {
+        std::uint32_t phaseEnd = self.now() + (chase ? GHOST_CHASE_TICKS : GHOST_SCATTER_TICKS);
+        // Ghosts turn round whenever the phase changes
+        if (!first && self.direction != Direction::Stay) self.direction = Actor::reverseOf(self.direction);
+
+        while (self.now() < phaseEnd) {
+            if (world.frightened(self.now())) {
+                if (frightenedSeen != world.frightenedSince) {
+                    // Turn round once when frightened mode starts
+                    frightenedSeen = world.frightenedSince;
+                    self.direction = Actor::reverseOf(self.direction);
+                }
+                self.direction = pickExit(self.options(), counterRandom(self.seed, self.now(), 0, RandomPurpose::GhostFlee));
+            } else {
+                int targetX, targetY;
+                if (chase) {
+                    chaseTarget(world, self, personality, targetX, targetY);
+                } else {
+                    scatterTarget(world, personality, targetX, targetY);
+                }
+                self.direction = steerToward(self, self.options(), targetX, targetY);
+            }
+            co_await self.junction();
+        }
+    }
+}
+
+// Runs the ghosts of one SimState as actors. SimState stays the plain copy
+// of positions and owns the timers (power mode, respawns); the behaviour
+// state lives in the coroutine frames.
+class GhostDirector {
+public:
+    GhostDirector() : scheduler_(MAX_GHOSTS, world_.exits) {}
+
+    // New level or new game: respawns one actor per ghost in state, each
+    // with a random key derived from key and its slot
+    void reset(const SimState &state, int houseExitX, int houseExitY, std::uint64_t key,
+               const ExitMasks *levelExits = nullptr) {
+        scheduler_.clear();
+        world_ = GhostWorld();
+        world_.build(state, houseExitX, houseExitY, levelExits);
+        for (int i = 0; i < state.ghostCount; ++i) {
+            const SimGhost &ghost = state.ghosts[i];
+            int x = ghost.x, y = ghost.y;
+            stepOutOfWall(state, x, y);
+            Actor *actor = scheduler_.create(x, y, ghost.number);
+            actor->seed = deriveRandomKey(key, static_cast<std::uint32_t>(i));
+            scheduler_.start(*actor, classicGhost(*actor, world_));
+            actors_[i] = actor;
+            eaten_[i] = ghost.eaten;
+        }
+        ghostCount_ = state.ghostCount;
+        powerTimer_ = 0;
+    }
+
+    // Moves the ghosts one tick after Pacman moved in direction
+    void tick(SimState &state, Direction direction) {
+        world_.pacmanX = state.pacmanX;
+        world_.pacmanY = state.pacmanY;
+        if (direction != Direction::Stay) world_.pacmanDirection = direction;
+
+        // Frightened mode follows the sim's power timer; a new timer (another
+        // power pellet) makes the ghosts turn round again
+        if (state.powerTimer != powerTimer_) {
+            powerTimer_ = state.powerTimer;
+            if (powerTimer_) world_.frightenedSince = scheduler_.now() + 1;
+        }
+        world_.frightenedUntil = scheduler_.now() + 1 + state.timers.remaining(state.powerTimer);
+
+        scheduler_.tick();
+
+        for (int i = 0; i < ghostCount_; ++i) {
+            Actor &actor = *actors_[i];
+            SimGhost &ghost = state.ghosts[i];
+            // An eaten ghost's actor keeps running off the board and is put
+            // back on the spawn cell when the sim respawns the ghost
+            if (eaten_[i] && !ghost.eaten) {
+                int x = ghost.x, y = ghost.y;
+                stepOutOfWall(state, x, y);
+                actor.x = static_cast<std::int16_t>(x);
+                actor.y = static_cast<std::int16_t>(y);
+            }
+            eaten_[i] = ghost.eaten;
+            if (ghost.eaten) continue;
+            int d = static_cast<int>(actor.direction);
+            ghost.dx = static_cast<std::int8_t>(d < 4 ? DIRECTION_DX[d] : 0);
+            ghost.dy = static_cast<std::int8_t>(d < 4 ? DIRECTION_DY[d] : 0);
+            ghost.x = actor.x;
+            ghost.y = actor.y;
+        }
+    }
+
+    const ActorScheduler &scheduler() const { return scheduler_; }
+
+private:
+    // A spawn inside a wall (the classic '3') steps out to the first open
+    // neighbour, as the random walk does on its first move
+    static void stepOutOfWall(const SimState &state, int &x, int &y) {
+        int fromX = x, fromY = y;
+        for (int d = 0; d < 4 && !isWalkable(state, x, y); ++d) {
+            if (isWalkable(state, fromX + DIRECTION_DX[d], fromY + DIRECTION_DY[d])) {
+                x = fromX + DIRECTION_DX[d];
+                y = fromY + DIRECTION_DY[d];
+            }
+        }
+    }
+
+    GhostWorld world_;
+    ActorScheduler scheduler_;
+    std::array<Actor *, MAX_GHOSTS> actors_{};
+    std::array<bool, MAX_GHOSTS> eaten_{};
+    int ghostCount_ = 0;
+    TimerId powerTimer_ = 0;
+};
+
+// The '0' cell of a map sketch, where ghosts leave the house
+inline bool findHouseExit(const std::array<std::string, MAP_HEIGHT> &sketch, int &x, int &y) {
+    for (int row = 0; row < MAP_HEIGHT; ++row) {
+        std::size_t column = sketch[row].find('0');
+        if (column != std::string::npos) {
+            x = static_cast<int>(column);
+            y = row;
+            return true;
+        }
+    }
+    x = y = -1;
+    return false;
+}
@@ -0,0 +1,156 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "pacman_sim.h"
+#include "pacman_map.h"
+#include "soft_render.h"
+#include "frame_capture.h"
+
+// Runs the game without a window: the simulation is driven by a random
+// walk and every frame is drawn by the software renderer. Nothing waits
+// for a display refresh, so the reported frames per second is pure render
+// (and optional write) throughput.
+//
+// Usage: headless [--frames N] [--ppm DIR] [--raw FILE] [--every K] [--seed S] [--async] [--queue N] [--block]
+//   --ppm DIR   write DIR/frame_00000.ppm, ... (DIR must exist)
+//   --raw FILE  append every written frame to FILE as RGB24
+//   --every K   only write every K-th frame (all frames are still rendered)
+//   --async     hand frames to a writer thread (frame_capture.h) instead of
+//               writing them inline; frames are dropped when it falls behind
+//   --queue N   frames buffered for the writer thread (default 8)
+//   --block     wait for the writer instead of dropping frames
+
+// Keeps going straight, picks a random open exit at junctions and walls
+Direction randomWalk(const SimState &state, Direction current, SimRng &rng) {
+    Direction options[4];
+    int count = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (isWalkable(state, state.pacmanX + DIRECTION_DX[d], state.pacmanY + DIRECTION_DY[d])) {
+            options[count++] = static_cast<Direction>(d);
+        }
+    }
+    if (count == 0) return Direction::Stay;
+    bool straight = current != Direction::Stay &&
+                    isWalkable(state, state.pacmanX + DIRECTION_DX[static_cast<int>(current)],
+                               state.pacmanY + DIRECTION_DY[static_cast<int>(current)]);
+    if (straight && count <= 2) return current;
+    return options[rng.next() % count];
+}
+
+int main(int argc, char *argv[]) {
+    long frames = 1000;
+    long every = 1;
+    std::uint64_t seed = 1;
+    std::string ppmDir, rawPath;
+    bool async = false;
+    CaptureConfig capture;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--frames") == 0 && hasValue) frames = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--every") == 0 && hasValue) every = std::max(std::atol(argv[++i]), 1L);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--ppm") == 0 && hasValue) ppmDir = argv[++i];
+        else if (std::strcmp(argv[i], "--raw") == 0 && hasValue) rawPath = argv[++i];
+        else if (std::strcmp(argv[i], "--async") == 0) async = true;
+        else if (std::strcmp(argv[i], "--queue") == 0 && hasValue) capture.queueFrames = std::max(std::atoi(argv[++i]), 1);
+        else if (std::strcmp(argv[i], "--block") == 0) capture.blockWhenFull = true;
+        else {
+            std::cerr << "Unknown or incomplete option " << argv[i] << std::endl;
+            return -1;
+        }
+    }
+    if (frames <= 0) {
+        std::cerr << "--frames must be at least 1" << std::endl;
+        return -1;
+    }
+
+    SoftRenderer renderer;
+    std::unique_ptr<FrameCapture> recorder;
+    if (async && (!ppmDir.empty() || !rawPath.empty())) {
+        capture.rawPath = rawPath;
+        capture.ppmDir = ppmDir;
+        capture.every = static_cast<int>(every);
+        recorder.reset(new FrameCapture(capture, renderer.frame().width, renderer.frame().height));
+        if (!recorder->open()) return -1;
+    }
+
+    std::FILE *raw = nullptr;
+    if (!rawPath.empty() && !recorder) {
+        raw = std::fopen(rawPath.c_str(), "wb");
+        if (!raw) {
+            std::cerr << "Failed to open " << rawPath << std::endl;
+            return -1;
+        }
+    }
+
+    SimRng rng(seed);
+    SimState state = loadClassicSimState();
+    Direction direction = Direction::Right;
+
+    double renderSeconds = 0.0, writeSeconds = 0.0;
+    long written = 0, games = 1;
+    char path[4096];
+
+    for (long frame = 0; frame < frames; ++frame) {
+        if (simFinished(state)) {
+            state = loadClassicSimState();
+            games++;
+        }
+        direction = randomWalk(state, direction, rng);
+        stepSimState(state, direction, deriveRandomKey(seed, static_cast<std::uint32_t>(games)));
+
+        auto start = std::chrono::steady_clock::now();
+        renderer.render(state);
+        auto rendered = std::chrono::steady_clock::now();
+        renderSeconds += std::chrono::duration<double>(rendered - start).count();
+
+        if (recorder) {
+            recorder->capture(renderer.frame());
+            writeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - rendered).count();
+            continue;
+        }
+        if (frame % every != 0 || (ppmDir.empty() && !raw)) continue;
+
+        bool ok = true;
+        if (!ppmDir.empty()) {
+            std::snprintf(path, sizeof(path), "%s/frame_%05ld.ppm", ppmDir.c_str(), frame);
+            ok = writePpm(renderer.frame(), path);
+        }
+        if (raw) ok = writeRawFrame(renderer.frame(), raw) && ok;
+        if (!ok) {
+            std::cerr << "Failed to write frame " << frame << std::endl;
+            return -1;
+        }
+        written++;
+        writeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - rendered).count();
+    }
+
+    if (raw) std::fclose(raw);
+
+    const Framebuffer &fb = renderer.frame();
+    std::cout << frames << " frames at " << fb.width << "x" << fb.height << " over " << games << " game(s)" << std::endl;
+    std::cout << "render: " << frames / renderSeconds << " fps (" << renderSeconds / frames * 1e3 << " ms/frame)" << std::endl;
+    if (recorder) {
+        // Skipped and dropped frames never reach the writer, so the counts
+        // come from the capture once its queue has drained
+        recorder->close();
+        CaptureStats stats = recorder->stats();
+        written = static_cast<long>(stats.written);
+        if (stats.captured > 0) {
+            std::cout << "render+capture: " << frames / (renderSeconds + writeSeconds) << " fps, " << stats.captured
+                      << " frames handed to the writer (" << writeSeconds / stats.captured * 1e3 << " ms/frame), "
+                      << written << " written" << std::endl;
+        }
+    } else if (written > 0) {
+        std::cout << "render+write: " << frames / (renderSeconds + writeSeconds) << " fps, " << written << " frames written ("
+                  << writeSeconds / written * 1e3 << " ms/frame)" << std::endl;
+    }
+    recorder.reset();  // Prints what the writer dropped
+    return 0;
+}
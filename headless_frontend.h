@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "engine.h"
+#include "soft_render.h"
+
+// Engine frontend without a window: frames go to the software renderer, so
+// every threading policy can be timed on a machine with no display. For
+// repeatable input set EngineConfig::scriptedInput, which the engine applies
+// per tick on the stepping thread, bypassing the input thread; this
+// frontend only adds random presses, which do go through it.
+
+struct LatencyStats {
+    std::uint64_t frames = 0;
+    double meanMilliseconds = 0.0;
+    double p99Milliseconds = 0.0;
+    double maxMilliseconds = 0.0;
+};
+
+class HeadlessFrontend {
+public:
+    // render=false skips rasterising, leaving only the engine's own cost.
+    // randomInput presses a fresh random direction on every poll, which
+    // exercises the input-to-sim handoff but depends on thread timing and
+    // so is not repeatable.
+    explicit HeadlessFrontend(std::uint64_t inputSeed, bool render = true, bool randomInput = false,
+                              std::size_t maxSamples = 1 << 20)
+        : render_(render), randomInput_(randomInput), inputRng_(splitMix64(inputSeed)) {
+        latencies_.reserve(maxSamples);
+    }
+
+    // Records the rendered frames; only takes effect when rendering
+    void record(const CaptureConfig &capture) { captureConfig_ = capture; }
+
+    bool open() {
+        if (captureConfig_.enabled() && render_) {
+            const Framebuffer &frame = renderer_.frame();
+            capture_.reset(new FrameCapture(captureConfig_, frame.width, frame.height));
+            if (!capture_->open()) return false;
+        }
+        open_ = true;
+        return true;
+    }
+
+    bool isOpen() const { return open_; }
+
+    void processEvents(InputState &) {}
+
+    void pollInput(InputState &input, const SimState &) {
+        if (randomInput_) input.press(static_cast<Direction>(inputRng_.next() & 3));
+    }
+
+    void draw(const GameSnapshot &snapshot) {
+        if (render_) renderer_.render(snapshot.state);
+        drawnSampledAt_ = snapshot.sampledAt;
+    }
+
+    // Step-to-present latency of the frame just drawn: from the tick
+    // reading its input to now
+    void present() {
+        if (capture_) capture_->capture(renderer_.frame());
+        frames_++;
+        if (latencies_.size() < latencies_.capacity()) {
+            latencies_.push_back(std::chrono::duration<float, std::milli>(EngineClock::now() - drawnSampledAt_).count());
+        }
+    }
+
+    void finish(const GameSnapshot &, bool) {
+        capture_.reset();  // Drains the writer and prints its stats
+        open_ = false;
+    }
+
+    const Framebuffer &frame() const { return renderer_.frame(); }
+    std::uint64_t frames() const { return frames_; }
+
+    LatencyStats latency() const {
+        LatencyStats stats;
+        stats.frames = frames_;
+        if (latencies_.empty()) return stats;
+
+        std::vector<float> sorted(latencies_);
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (float value : sorted) sum += value;
+        stats.meanMilliseconds = sum / sorted.size();
+        stats.p99Milliseconds = sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
+        stats.maxMilliseconds = sorted.back();
+        return stats;
+    }
+
+private:
+    bool render_;
+    bool randomInput_;
+    SimRng inputRng_;   // Only touched by the thread that polls input
+    bool open_ = false;
+    SoftRenderer renderer_;
+    CaptureConfig captureConfig_;
+    std::unique_ptr<FrameCapture> capture_;
+    EngineClock::time_point drawnSampledAt_{};
+    std::uint64_t frames_ = 0;
+    std::vector<float> latencies_;
+};
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pacman_sim.h"
+
+// Binary level packs. levelc compiles text maps offline into a file of
+// ready-made levels: the board with its pellets, Pacman and ghost spawns
+// and the exit masks the ghost actors steer by. At runtime the file is
+// mmap'd and each level is used in place, so loading one is a copy, not a
+// parse, and the ghosts do not recompute their navigation data.
+//
+// Layout: a LevelPackHeader followed by levelCount PackedLevel records,
+// each levelStride bytes apart. PackedLevel embeds SimState verbatim, so
+// LEVEL_PACK_VERSION must be bumped whenever SimState or PackedLevel
+// changes, even when the size stays the same.
+//
+// The boards are loaded with the columns and pellets rules levelc was
+// given, so the header records them and a game only opens a pack built
+// for its own rules.
+
+constexpr char LEVEL_PACK_MAGIC[8] = {'P', 'A', 'C', 'L', 'V', 'L', '\0', '\0'};
+constexpr std::uint32_t LEVEL_PACK_VERSION = 3;  // 3: rules in the header, junctions dropped, 32-byte names
+constexpr std::uint32_t LEVEL_PACK_BYTE_ORDER = 0x01020304;
+
+struct LevelPackHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;     // Packs are native-endian; rejects a foreign one
+    std::uint32_t stateSize;     // sizeof(SimState) the pack was built with
+    std::uint32_t levelStride;   // Bytes from one PackedLevel to the next
+    std::uint32_t levelCount;
+    std::uint32_t levelsOffset;  // File offset of the first PackedLevel
+    std::int32_t columns;        // GameRules::columns the boards were loaded with
+    std::uint32_t pellets;       // GameRules::pellets, 0 or 1
+};
+
+struct alignas(64) PackedLevel {
+    SimState initial;            // Board, spawns, lives and pellet count at the start
+    ExitMasks exits;             // Open neighbours per cell, EXIT_BIT per direction
+    char name[32];               // Map file or generator seed, for messages
+};
+
+static_assert(std::is_trivially_copyable<PackedLevel>::value, "PackedLevel is written and mapped as raw bytes");
+
+inline PackedLevel packLevel(const SimState &initial, const std::string &name) {
+    PackedLevel level{};
+    level.initial = initial;
+    computeExitMasks(initial, level.exits);
+    std::strncpy(level.name, name.c_str(), sizeof(level.name) - 1);
+    return level;
+}
+
+// Returns nullptr when a level is safe to play, otherwise what is wrong.
+// Packs come from files, so nothing in one is trusted: the starting state
+// gets the full invariant and range check and the exit masks must be the
+// ones its board gives.
+inline const char *checkPackedLevel(const PackedLevel &level, const GameRules &rules) {
+    if (std::memchr(level.name, '\0', sizeof(level.name)) == nullptr) return "name is not terminated";
+    if (const char *problem = checkSimInvariants(level.initial, rules, true)) return problem;
+    if (!rules.pellets && level.initial.pellets != 0) return "has pellets, but the pack was built without them";
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        for (int x = rules.columns; x < MAP_WIDTH; ++x) {
+            if (level.initial.board[y][x] != CellType::Wall) return "open cells right of the pack's columns";
+        }
+    }
+    ExitMasks exits;
+    computeExitMasks(level.initial, exits);
+    if (exits != level.exits) return "exit masks do not match the board";
+    return nullptr;
+}
+
+inline bool writeLevelPack(const std::vector<PackedLevel> &levels, const GameRules &rules, const std::string &path) {
+    LevelPackHeader header{};
+    std::memcpy(header.magic, LEVEL_PACK_MAGIC, sizeof(header.magic));
+    header.version = LEVEL_PACK_VERSION;
+    header.byteOrder = LEVEL_PACK_BYTE_ORDER;
+    header.stateSize = sizeof(SimState);
+    header.levelStride = sizeof(PackedLevel);
+    header.levelCount = static_cast<std::uint32_t>(levels.size());
+    header.columns = rules.columns;
+    header.pellets = rules.pellets ? 1 : 0;
+    header.levelsOffset = alignof(PackedLevel) * ((sizeof(LevelPackHeader) + alignof(PackedLevel) - 1) / alignof(PackedLevel));
+
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    char padding[alignof(PackedLevel)] = {};
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(padding, header.levelsOffset - sizeof(header), 1, file) == 1 &&
+              std::fwrite(levels.data(), sizeof(PackedLevel), levels.size(), file) == levels.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// Read-only view of a pack file. The levels stay in the page cache and are
+// shared by every process that plays the same pack.
+class LevelPack {
+public:
+    LevelPack() = default;
+    ~LevelPack() { close(); }
+
+    LevelPack(const LevelPack &) = delete;
+    LevelPack &operator=(const LevelPack &) = delete;
+
+    // Opens a pack built for the columns and pellets of rules
+    bool open(const std::string &path, const GameRules &rules) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Failed to open level pack " << path << std::endl;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(LevelPackHeader))) {
+            std::cerr << "Level pack " << path << " is too small" << std::endl;
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            std::cerr << "Failed to map level pack " << path << std::endl;
+            return false;
+        }
+        data_ = static_cast<const unsigned char *>(data);
+
+        const char *problem = validate(rules);
+        if (problem) {
+            std::cerr << "Level pack " << path << ": " << problem << std::endl;
+            close();
+            return false;
+        }
+        // Every level is checked up front, so a bad one rejects the whole
+        // pack instead of failing halfway through a game
+        for (int i = 0; i < size(); ++i) {
+            problem = checkPackedLevel(level(i), rules);
+            if (problem) {
+                std::cerr << "Level pack " << path << ", level " << i;
+                if (std::memchr(level(i).name, '\0', sizeof(level(i).name))) std::cerr << " (" << level(i).name << ")";
+                std::cerr << ": " << problem << std::endl;
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void close() {
+        if (data_) munmap(const_cast<unsigned char *>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    bool isOpen() const { return data_ != nullptr; }
+    int size() const { return data_ ? static_cast<int>(header().levelCount) : 0; }
+
+    const PackedLevel &level(int index) const {
+        return *reinterpret_cast<const PackedLevel *>(data_ + header().levelsOffset + static_cast<std::size_t>(index) * sizeof(PackedLevel));
+    }
+
+    // Asks the kernel to read a level's pages ahead of use
+    void prefetch(int index) const {
+        const unsigned char *begin = reinterpret_cast<const unsigned char *>(&level(index));
+        long page = sysconf(_SC_PAGESIZE);
+        const unsigned char *aligned = data_ + (begin - data_) / page * page;
+        madvise(const_cast<unsigned char *>(aligned), begin + sizeof(PackedLevel) - aligned, MADV_WILLNEED);
+    }
+
+private:
+    const LevelPackHeader &header() const { return *reinterpret_cast<const LevelPackHeader *>(data_); }
+
+    const char *validate(const GameRules &rules) const {
+        const LevelPackHeader &h = header();
+        if (std::memcmp(h.magic, LEVEL_PACK_MAGIC, sizeof(h.magic)) != 0) return "not a level pack";
+        if (h.version != LEVEL_PACK_VERSION) return "unsupported version, recompile it with levelc";
+        if (h.byteOrder != LEVEL_PACK_BYTE_ORDER) return "built on a machine with a different byte order";
+        if (h.stateSize != sizeof(SimState) || h.levelStride != sizeof(PackedLevel)) return "built for a different game layout";
+        if (h.levelsOffset % alignof(PackedLevel) != 0) return "misaligned level table";
+        if (h.columns != rules.columns || h.pellets != (rules.pellets ? 1u : 0u)) {
+            return "built for other rules, recompile it with levelc --columns/--no-pellets to match";
+        }
+        if (h.levelCount == 0) return "no levels";
+        if (h.levelsOffset + static_cast<std::size_t>(h.levelCount) * sizeof(PackedLevel) > size_) return "truncated";
+        return nullptr;
+    }
+
+    const unsigned char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Prepares the next level on a background thread while the current one is
+// played: its pages are faulted in and its state and exit masks copied
+// out, so switching levels on the game thread is two copies with no page
+// faults.
+class LevelStreamer {
+public:
+    explicit LevelStreamer(const LevelPack &pack) : pack_(pack), thread_(&LevelStreamer::loaderLoop, this) {}
+
+    ~LevelStreamer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    LevelStreamer(const LevelStreamer &) = delete;
+    LevelStreamer &operator=(const LevelStreamer &) = delete;
+
+    // Starts preparing a level; a newer request replaces an older one
+    void request(int index) {
+        if (index < 0 || index >= pack_.size()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (requested_ == index || readyIndex_ == index) return;
+            requested_ = index;
+        }
+        wake_.notify_one();
+    }
+
+    // Copies out a level, from the prepared buffer when it is ready and
+    // straight from the mapping otherwise
+    void take(int index, SimState &out, ExitMasks &exits) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (readyIndex_ == index) {
+                out = ready_.initial;
+                exits = ready_.exits;
+                hits_++;
+                return;
+            }
+        }
+        const PackedLevel &level = pack_.level(index);
+        out = level.initial;
+        exits = level.exits;
+        misses_++;
+    }
+
+    int hits() const { return hits_; }
+    int misses() const { return misses_; }
+
+private:
+    void loaderLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return stopping_ || requested_ >= 0; });
+            if (stopping_) return;
+            int index = requested_;
+            requested_ = -1;
+            lock.unlock();
+
+            pack_.prefetch(index);
+            PackedLevel level = pack_.level(index);
+
+            lock.lock();
+            ready_ = level;
+            readyIndex_ = index;
+        }
+    }
+
+    const LevelPack &pack_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    PackedLevel ready_{};
+    int readyIndex_ = -1;
+    int requested_ = -1;
+    bool stopping_ = false;
+    std::atomic<int> hits_{0};
+    std::atomic<int> misses_{0};
+    std::thread thread_;  // Last, so it starts after everything it uses
+};
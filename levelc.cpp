@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pacman_sim.h"
+#include "pacman_map.h"
+#include "mazegen.h"
+#include "level_pack.h"
+
+// Level compiler: turns text maps into a binary level pack (level_pack.h)
+// that the game maps and plays without parsing.
+//
+// Usage: levelc OUT [--columns N] [--no-pellets] [--classic] [--generated N] [--seed S] [--verify] [MAP.txt ...]
+//   --columns N    wall off every cell right of column N (GameRules::columns)
+//   --no-pellets   load '.' and 'o' as empty floor (GameRules::pellets off)
+//   --classic      add the built-in level with its three ghosts
+//   --generated N  add N procedurally generated mazes, seeds S, S+1, ...
+//   --verify       map the written pack back, list its levels and time loading them
+//   MAP.txt        up to 22 lines in map_sketch symbols, ghosts as '1'-'9'
+//
+// Levels are stored in the order given. The rules options apply to the
+// levels after them, so give them first; the pack records them and only
+// opens in a game with the same columns and pellets rules.
+
+bool readMapFile(const std::string &path, std::array<std::string, MAP_HEIGHT> &sketch) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    for (int y = 0; y < MAP_HEIGHT && std::getline(in, line); ++y) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        sketch[y] = line;
+    }
+    return true;
+}
+
+SimState generatedLevel(std::uint32_t seed, const GameRules &rules) {
+    MazeOptions options;
+    options.width = MAZE_WIDTH;
+    options.height = MAP_HEIGHT - 1;
+    options.seed = seed;
+    GeneratedMaze maze = generateMaze(options);
+
+    std::array<std::string, MAP_HEIGHT> sketch;
+    for (int y = 0; y < maze.height && y < MAP_HEIGHT; ++y) sketch[y] = maze.rows[y];
+    SimState state = loadSimState(sketch, rules);
+    for (const auto &spawn : CLASSIC_GHOSTS) addSimGhost(state, maze.ghostX, maze.ghostY, spawn.number);
+    return state;
+}
+
+bool verifyPack(const std::string &path, const std::vector<PackedLevel> &levels, const GameRules &rules) {
+    auto start = std::chrono::steady_clock::now();
+    LevelPack pack;
+    if (!pack.open(path, rules)) return false;
+    auto opened = std::chrono::steady_clock::now();
+
+    SimState state;
+    for (int i = 0; i < pack.size(); ++i) {
+        state = pack.level(i).initial;
+        if (std::memcmp(&state, &levels[i].initial, sizeof(SimState)) != 0) {
+            std::cerr << "Level " << i << " does not match after reading it back" << std::endl;
+            return false;
+        }
+    }
+    auto loaded = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < pack.size(); ++i) {
+        const SimState &initial = pack.level(i).initial;
+        std::cout << "  " << i << ": " << pack.level(i).name << ", " << initial.pellets << " pellets, "
+                  << initial.ghostCount << " ghosts" << std::endl;
+    }
+
+    std::cout << "Verified: open " << std::chrono::duration<double, std::micro>(opened - start).count() << " us, "
+              << std::chrono::duration<double, std::micro>(loaded - opened).count() / pack.size() << " us per level" << std::endl;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: levelc OUT [--columns N] [--no-pellets] [--classic] [--generated N] [--seed S] [--verify] [MAP.txt ...]" << std::endl;
+        return -1;
+    }
+    std::string outPath = argv[1];
+    std::vector<PackedLevel> levels;
+    GameRules rules;
+    std::uint32_t seed = 1;
+    bool verify = false;
+
+    for (int i = 2; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--columns") == 0 && hasValue) {
+            rules.columns = std::atoi(argv[++i]);
+            if (rules.columns < 1 || rules.columns > MAP_WIDTH) {
+                std::cerr << "--columns must be between 1 and " << MAP_WIDTH << std::endl;
+                return -1;
+            }
+        } else if (std::strcmp(argv[i], "--no-pellets") == 0) {
+            rules.pellets = false;
+        } else if (std::strcmp(argv[i], "--classic") == 0) {
+            levels.push_back(packLevel(loadClassicSimState(rules), "classic"));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--generated") == 0 && hasValue) {
+            int count = std::atoi(argv[++i]);
+            for (int n = 0; n < count; ++n, ++seed) {
+                levels.push_back(packLevel(generatedLevel(seed, rules), "maze " + std::to_string(seed)));
+            }
+        } else if (std::strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        } else if (argv[i][0] != '-') {
+            std::array<std::string, MAP_HEIGHT> sketch;
+            if (!readMapFile(argv[i], sketch)) {
+                std::cerr << "Failed to read map " << argv[i] << std::endl;
+                return -1;
+            }
+            SimState state = loadSimState(sketch, rules);
+            if ((rules.pellets && state.pellets == 0) || state.board[state.pacmanY][state.pacmanX] != CellType::Pacman) {
+                std::cerr << "Map " << argv[i] << " needs a 'P' and at least one pellet" << std::endl;
+                return -1;
+            }
+            levels.push_back(packLevel(state, argv[i]));
+        } else {
+            std::cerr << "Unknown or incomplete option " << argv[i] << std::endl;
+            return -1;
+        }
+    }
+
+    if (levels.empty()) {
+        std::cerr << "No levels given" << std::endl;
+        return -1;
+    }
+    if (!writeLevelPack(levels, rules, outPath)) {
+        std::cerr << "Failed to write " << outPath << std::endl;
+        return -1;
+    }
+    std::cout << "Wrote " << levels.size() << " level(s), " << sizeof(PackedLevel) << " bytes each, to " << outPath << std::endl;
+
+    if (verify && !verifyPack(outPath, levels, rules)) return -1;
+    return 0;
+}
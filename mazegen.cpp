@@ -0,0 +1,51 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "mazegen.h"
+
+// Usage: mazegen [width] [height] [seed] [repeat]
+// Prints the maze (when it is small enough to read) and how long generation
+// and validation took. With repeat > 1 the seed is advanced each round and
+// the average time per maze is reported.
+int main(int argc, char *argv[]) {
+    MazeOptions options;
+    if (argc > 1) options.width = std::atoi(argv[1]);
+    if (argc > 2) options.height = std::atoi(argv[2]);
+    if (argc > 3) options.seed = static_cast<std::uint32_t>(std::strtoul(argv[3], nullptr, 10));
+    int repeat = argc > 4 ? std::max(std::atoi(argv[4]), 1) : 1;
+
+    GeneratedMaze maze;
+    double generateSeconds = 0.0, validateSeconds = 0.0;
+    bool allValid = true;
+
+    for (int i = 0; i < repeat; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        maze = generateMaze(options);
+        auto generated = std::chrono::steady_clock::now();
+        MazeReport report = validateMaze(maze.rows);
+        auto validated = std::chrono::steady_clock::now();
+
+        generateSeconds += std::chrono::duration<double>(generated - start).count();
+        validateSeconds += std::chrono::duration<double>(validated - generated).count();
+
+        if (!report.connected || report.deadEnds != 0 || report.pellets != maze.pellets) {
+            std::cerr << "Seed " << options.seed << ": connected=" << report.connected
+                      << " deadEnds=" << report.deadEnds << " pellets=" << report.pellets
+                      << "/" << maze.pellets << std::endl;
+            allValid = false;
+        }
+        options.seed++;
+    }
+
+    if (maze.width <= 200) {
+        for (const auto &row : maze.rows) std::cout << row << '\n';
+    }
+
+    std::cout << maze.width << "x" << maze.height << ", pellets " << maze.pellets
+              << ", generate " << generateSeconds / repeat * 1e6 << " us"
+              << ", validate " << validateSeconds / repeat * 1e6 << " us"
+              << (allValid ? ", all mazes connected with no dead ends" : ", INVALID mazes found") << std::endl;
+
+    return allValid ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Procedural Pac-Man style mazes. The left half is carved as a random
+// spanning tree over a lattice of odd cells (Kruskal with union-find), dead
+// ends are knocked open, and the result is mirrored so the board is
+// left/right symmetric. The output uses the same symbols as map_sketch.
+
+struct MazeOptions {
+    int width = 21;           // Forced odd, at least 7
+    int height = 21;          // Forced odd, at least 7
+    std::uint32_t seed = 1;
+    double loopFactor = 0.1;  // Share of remaining inner walls opened for extra loops
+};
+
+struct GeneratedMaze {
+    int width = 0, height = 0;
+    std::vector<std::string> rows;
+    int pellets = 0;          // '.' plus 'o' cells
+    int pacmanX = 0, pacmanY = 0;
+    int ghostX = 0, ghostY = 0;
+};
+
+struct MazeReport {
+    bool connected = false;
+    int openCells = 0;
+    int reachableCells = 0;
+    int deadEnds = 0;
+    int pellets = 0;
+};
+
+struct DisjointSet {
+    std::vector<int> parent, size;
+
+    explicit DisjointSet(int count) : parent(count), size(count, 1) {
+        for (int i = 0; i < count; ++i) parent[i] = i;
+    }
+
+    int find(int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (size[a] < size[b]) std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+        return true;
+    }
+};
+
+inline bool isMazeOpen(char ch) {
+    return ch != '#';
+}
+
+// Counts open neighbours of an open cell
+inline int mazeDegree(const std::vector<std::string> &rows, int x, int y) {
+    int degree = 0;
+    if (y > 0 && isMazeOpen(rows[y - 1][x])) degree++;
+    if (y + 1 < static_cast<int>(rows.size()) && isMazeOpen(rows[y + 1][x])) degree++;
+    if (x > 0 && isMazeOpen(rows[y][x - 1])) degree++;
+    if (x + 1 < static_cast<int>(rows[y].size()) && isMazeOpen(rows[y][x + 1])) degree++;
+    return degree;
+}
+
+// BFS over every non-wall cell; also counts dead ends and pellets
+inline MazeReport validateMaze(const std::vector<std::string> &rows) {
+    MazeReport report;
+    int height = static_cast<int>(rows.size());
+    if (height == 0) return report;
+    int width = static_cast<int>(rows[0].size());
+
+    std::vector<std::uint8_t> seen(static_cast<std::size_t>(width) * height, 0);
+    std::vector<int> queue;
+    queue.reserve(static_cast<std::size_t>(width) * height);
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            char ch = rows[y][x];
+            if (!isMazeOpen(ch)) continue;
+            report.openCells++;
+            if (ch == '.' || ch == 'o') report.pellets++;
+            if (mazeDegree(rows, x, y) <= 1) report.deadEnds++;
+            if (queue.empty()) {
+                queue.push_back(y * width + x);
+                seen[y * width + x] = 1;
+            }
+        }
+    }
+
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        int x = queue[head] % width, y = queue[head] / width;
+        const int dx[4] = {0, 0, -1, 1};
+        const int dy[4] = {-1, 1, 0, 0};
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d], ny = y + dy[d];
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height) continue;
+            int index = ny * width + nx;
+            if (!seen[index] && isMazeOpen(rows[ny][nx])) {
+                seen[index] = 1;
+                queue.push_back(index);
+            }
+        }
+    }
+
+    report.reachableCells = static_cast<int>(queue.size());
+    report.connected = report.reachableCells == report.openCells;
+    return report;
+}
+
+inline GeneratedMaze generateMaze(const MazeOptions &options) {
+    int width = std::max(options.width, 7) | 1;
+    int height = std::max(options.height, 7) | 1;
+    int axis = width / 2;
+    std::mt19937 eng(options.seed);
+
+    GeneratedMaze maze;
+    maze.width = width;
+    maze.height = height;
+    maze.rows.assign(height, std::string(width, '#'));
+    auto &rows = maze.rows;
+
+    auto openSymmetric = [&](int x, int y) {
+        rows[y][x] = '.';
+        rows[y][width - 1 - x] = '.';
+    };
+
+    // Lattice of carve cells at odd coordinates on the left half, axis included
+    int cols = (axis + 1) / 2;
+    int cellRows = (height - 1) / 2;
+    auto cellIndex = [&](int cx, int cy) { return cy * cols + cx; };
+
+    std::vector<std::pair<int, int>> edges; // (cell, 0 = right / 1 = down)
+    edges.reserve(static_cast<std::size_t>(cols) * cellRows * 2);
+    for (int cy = 0; cy < cellRows; ++cy) {
+        for (int cx = 0; cx < cols; ++cx) {
+            openSymmetric(2 * cx + 1, 2 * cy + 1);
+            if (cx + 1 < cols) edges.emplace_back(cellIndex(cx, cy), 0);
+            if (cy + 1 < cellRows) edges.emplace_back(cellIndex(cx, cy), 1);
+        }
+    }
+    std::shuffle(edges.begin(), edges.end(), eng);
+
+    DisjointSet sets(cols * cellRows);
+    std::vector<std::pair<int, int>> spare;
+    for (const auto &edge : edges) {
+        int cx = edge.first % cols, cy = edge.first / cols;
+        int other = edge.second == 0 ? edge.first + 1 : edge.first + cols;
+        int wallX = 2 * cx + 1 + (edge.second == 0 ? 1 : 0);
+        int wallY = 2 * cy + 1 + (edge.second == 1 ? 1 : 0);
+        if (sets.unite(edge.first, other)) {
+            openSymmetric(wallX, wallY);
+        } else {
+            spare.emplace_back(wallX, wallY);
+        }
+    }
+
+    // With an even axis column the two halves only meet where it is opened
+    if (axis % 2 == 0) {
+        std::uniform_int_distribution<> pick(0, 3);
+        bool joined = false;
+        for (int cy = 0; cy < cellRows; ++cy) {
+            if (pick(eng) == 0) {
+                rows[2 * cy + 1][axis] = '.';
+                joined = true;
+            }
+        }
+        if (!joined) rows[2 * (cellRows / 2) + 1][axis] = '.';
+    }
+
+    // Extra loops, so the board is not a pure tree
+    std::uniform_real_distribution<> chance(0.0, 1.0);
+    for (const auto &wall : spare) {
+        if (chance(eng) < options.loopFactor) openSymmetric(wall.first, wall.second);
+    }
+
+    // Knock open one wall next to every dead end, preferring a wall that
+    // fixes a second dead end at the same time. Handling the left half is
+    // enough because every opening is mirrored.
+    const int dx[4] = {0, 0, -1, 1};
+    const int dy[4] = {-1, 1, 0, 0};
+    for (int y = 1; y < height - 1; y += 2) {
+        for (int x = 1; x <= axis; x += 2) {
+            if (mazeDegree(rows, x, y) > 1) continue;
+
+            int bestWallX = -1, bestWallY = -1, bestScore = -1;
+            for (int d = 0; d < 4; ++d) {
+                int wallX = x + dx[d], wallY = y + dy[d];
+                int nx = x + 2 * dx[d], ny = y + 2 * dy[d];
+                if (nx < 1 || nx > width - 2 || ny < 1 || ny > height - 2) continue;
+                if (isMazeOpen(rows[wallY][wallX])) continue;
+                int score = (mazeDegree(rows, nx, ny) <= 1 ? 2 : 0) + static_cast<int>(eng() & 1);
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestWallX = wallX;
+                    bestWallY = wallY;
+                }
+            }
+            if (bestWallX >= 0) openSymmetric(bestWallX, bestWallY);
+        }
+    }
+
+    // Power pellets in the corners, Pacman near the bottom middle and the
+    // ghost spawn as close to the centre as the maze allows
+    rows[1][1] = rows[1][width - 2] = 'o';
+    rows[height - 2][1] = rows[height - 2][width - 2] = 'o';
+
+    auto nearestOpen = [&](int targetX, int targetY) {
+        int bestX = 1, bestY = 1, bestDistance = width + height;
+        for (int y = 1; y < height - 1; ++y) {
+            for (int x = 1; x < width - 1; ++x) {
+                int distance = std::abs(x - targetX) + std::abs(y - targetY);
+                if (rows[y][x] == '.' && distance < bestDistance) {
+                    bestDistance = distance;
+                    bestX = x;
+                    bestY = y;
+                }
+            }
+        }
+        return std::make_pair(bestX, bestY);
+    };
+
+    auto pacman = nearestOpen(axis, height - 2);
+    maze.pacmanX = pacman.first;
+    maze.pacmanY = pacman.second;
+    rows[maze.pacmanY][maze.pacmanX] = 'P';
+
+    auto ghost = nearestOpen(axis, height / 2);
+    maze.ghostX = ghost.first;
+    maze.ghostY = ghost.second;
+
+    for (const auto &row : rows) {
+        maze.pellets += static_cast<int>(std::count(row.begin(), row.end(), '.') + std::count(row.begin(), row.end(), 'o'));
+    }
+    return maze;
+}
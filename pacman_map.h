@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "pacman_sim.h"
+
+// Width of the playable part of the shipped levels; the rest of each
+// MAP_WIDTH row is empty space
+constexpr int MAZE_WIDTH = 21;
+
+// The level the threaded build and projectwithoutthreading.cpp use. Kept
+// here so every variant and the headless tools share exactly the same board.
+const std::array<std::string, MAP_HEIGHT> CLASSIC_MAP = {
+    " ###################                     ",
+    " #........#........#                     ",
+    " #o##.###.#.###.##o#                     ",
+    " #.................#                     ",
+    " #.##.#.#####.#.##.#                     ",
+    " #....#...#...#....#                     ",
+    " ####.### # ###.####                     ",
+    "    #.#   0   #.#                        ",
+    "#####.# #   # #.#####                    ",
+    "     .  #   #  .                         ",
+    "     .  #   #  .                         ",
+    "#####.# ##### #.#####                    ",
+    "    #.#       #.#                        ",
+    " ####.# ##### #.####                     ",
+    " #........#........#                     ",
+    " #.##.###.#.###.##.#                     ",
+    " #o.#.....P.....#.o#                     ",
+    " ##.#.###.#.###.#.##                     ",
+    " #........#........#                     ",
+    " #.##.###.#.###.##.#                     ",
+    " #o.................#                     ",
+    " ###################                     ",
+};
+
+// The level project.cpp and movementdraft1 use, with the ghosts ('1'-'3')
+// waiting in the ghost house behind the '=' door
+const std::array<std::string, MAP_HEIGHT> GHOST_HOUSE_MAP = {
+    " ###################                     ",
+    " #........#........#                     ",
+    " #o##.###.#.###.##o#                     ",
+    " #.................#                     ",
+    " #.##.#.#####.#.##.#                     ",
+    " #....#...#...#....#                     ",
+    " ####.### # ###.####                     ",
+    "    #.#   0   #.#                        ",
+    "#####.# ##=## #.#####                    ",
+    "     .  #   #  .                         ",
+    "     .  #123#  .                         ",
+    "#####.# ##### #.#####                    ",
+    "    #.#       #.#                        ",
+    " ####.# ##### #.####                     ",
+    " #........#........#                     ",
+    " #.##.###.#.###.##.#                     ",
+    " #o.#.....P.....#.o#                     ",
+    " ##.#.#.#####.#.#.##                     ",
+    " #....#...#...#....#                     ",
+    " #.######.#.######.#                     ",
+    " #.................#                     ",
+    " ###################                     "
+};
+
+struct GhostSpawn {
+    int x, y;
+    char number;
+};
+
+constexpr GhostSpawn CLASSIC_GHOSTS[] = {
+    {10, 10, '1'},
+    {2, 10, '2'},
+    {10, 15, '3'},
+};
+
+// SimState for the classic level with its ghosts placed
+inline SimState loadClassicSimState(const GameRules &rules = GameRules()) {
+    SimState state = loadSimState(CLASSIC_MAP, rules);
+    for (const auto &spawn : CLASSIC_GHOSTS) addSimGhost(state, spawn.x, spawn.y, spawn.number);
+    return state;
+}
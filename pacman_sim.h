@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "counter_rng.h"
+#include "timer_wheel.h"
+
+// Constants shared by the game and the simulation helpers
+constexpr int MAP_WIDTH = 41;
+constexpr int MAP_HEIGHT = 22;
+
+// Define symbols for game board elements
+enum class CellType : std::uint8_t { Wall, Path, Pellet, PowerPellet, Pacman, Ghost };
+
+// 0=up, 1=down, 2=left, 3=right, the order ghosts roll new directions in
+enum class Direction : std::uint8_t { Up, Down, Left, Right, Stay };
+
+constexpr int DIRECTION_DX[4] = {0, 0, -1, 1};
+constexpr int DIRECTION_DY[4] = {-1, 1, 0, 0};
+
+constexpr int MAX_GHOSTS = 4;
+
+// Rule switches that differ between the game variants. The defaults are the
+// threaded build's rules.
+struct GameRules {
+    int columns = MAP_WIDTH;       // Cells right of this column are solid wall
+    bool pellets = true;           // '.' and 'o' are food and clearing them wins
+    int pelletScore = 1;
+    int powerPelletScore = 10;
+    bool ghostsMove = true;
+    bool ghostsKill = true;        // Touching a ghost costs a life
+    bool respawnAfterHit = true;   // Pacman goes back to the start cell after a hit
+    bool holdDirection = true;     // Keep moving every tick, or one step per key press
+    int lives = 3;
+    int powerTicks = 30;           // Power mode after a power pellet, ghosts can be eaten; 0 = off
+    int ghostScore = 20;
+    int ghostRespawnTicks = 20;    // An eaten ghost is off the board this long
+};
+
+struct SimGhost {
+    std::int16_t x, y;
+    std::int8_t dx, dy;
+    char number;
+    bool eaten;                    // Off the board until its GhostRespawn timer fires
+    std::int16_t spawnX, spawnY;
+
+    bool operator==(const SimGhost &) const = default;
+};
+
+// Plain copy of everything the game loop mutates, pending timers included.
+// It holds no pointers and no heap memory, so cloning it is a single memcpy
+// of about 1.3 KB, and stepping a clone replays the game exactly.
+struct SimState {
+    std::array<std::array<CellType, MAP_WIDTH>, MAP_HEIGHT> board;
+    std::array<SimGhost, MAX_GHOSTS> ghosts;
+    int ghostCount;
+    int pacmanX, pacmanY;
+    int spawnX, spawnY;
+    int score;
+    int lives;
+    int pellets;
+    std::uint32_t tick;
+    TimerWheel timers;
+    TimerId powerTimer;            // Pending PowerEnd while in power mode, 0 otherwise
+
+    bool operator==(const SimState &) const = default;
+};
+
+static_assert(std::is_trivially_copyable<SimState>::value, "SimState must stay memcpy-able");
+
+// xorshift64* generator, small enough to embed in every rollout worker.
+// For one thread's own sequence (rollout policies, test input); the ghosts
+// draw from counter_rng.h so they share no generator state.
+struct SimRng {
+    std::uint64_t state;
+
+    explicit SimRng(std::uint64_t seed = 0x9E3779B97F4A7C15ull) : state(seed ? seed : 1) {}
+
+    std::uint32_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<std::uint32_t>((state * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+};
+
+inline bool inBounds(int x, int y) { return x >= 0 && x < MAP_WIDTH && y >= 0 && y < MAP_HEIGHT; }
+
+inline bool isWalkable(const SimState &state, int x, int y) { return inBounds(x, y) && state.board[y][x] != CellType::Wall; }
+
+// Bits of an exit mask, one per Direction
+constexpr std::uint8_t EXIT_BIT[4] = {1, 2, 4, 8};
+
+using ExitMasks = std::array<std::array<std::uint8_t, MAP_WIDTH>, MAP_HEIGHT>;
+
+// Open neighbours of one cell, for when no precomputed ExitMasks is at hand
+inline std::uint8_t cellExits(const SimState &state, int x, int y) {
+    std::uint8_t mask = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (isWalkable(state, x + DIRECTION_DX[d], y + DIRECTION_DY[d])) mask |= EXIT_BIT[d];
+    }
+    return mask;
+}
+
+// Open neighbours of every cell. Walls never change during a level, so this
+// only needs computing once per board.
+inline void computeExitMasks(const SimState &state, ExitMasks &exits) {
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        for (int x = 0; x < MAP_WIDTH; ++x) {
+            exits[y][x] = isWalkable(state, x, y) ? cellExits(state, x, y) : 0;
+        }
+    }
+}
+
+inline int exitCount(std::uint8_t mask) {
+    return (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+}
+
+// One of the exits in mask, uniformly, from a single random draw
+inline Direction pickExit(std::uint8_t mask, std::uint32_t random) {
+    int pick = static_cast<int>(randomBelow(random, static_cast<std::uint32_t>(exitCount(mask))));
+    for (int d = 0; d < 4; ++d) {
+        if ((mask & EXIT_BIT[d]) && pick-- == 0) return static_cast<Direction>(d);
+    }
+    return Direction::Stay;
+}
+
+inline bool simFinished(const SimState &state, const GameRules &rules = GameRules()) {
+    return (rules.ghostsKill && state.lives <= 0) || (rules.pellets && state.pellets == 0);
+}
+
+// Returns nullptr when the state is consistent, otherwise what is wrong:
+// the pellet count matches the board, there is exactly one Pacman cell and
+// it is where Pacman is, and every actor is on an open cell of the board.
+// Every index the step functions use (positions, spawns, ghost count, the
+// timer wheel) is range-checked first, so this is also safe on states read
+// from a file. levelStart is for the state a level starts from, where a
+// ghost may still stand on a spawn inside a wall (the classic '3'); its
+// first move steps it out.
+inline const char *checkSimInvariants(const SimState &state, const GameRules &rules = GameRules(), bool levelStart = false) {
+    if (!inBounds(state.pacmanX, state.pacmanY) || !inBounds(state.spawnX, state.spawnY)) return "Pacman or his spawn is out of bounds";
+    if (state.ghostCount < 0 || state.ghostCount > MAX_GHOSTS) return "ghost count out of range";
+    for (int i = 0; i < state.ghostCount; ++i) {
+        const SimGhost &ghost = state.ghosts[i];
+        if (!inBounds(ghost.x, ghost.y) || !inBounds(ghost.spawnX, ghost.spawnY)) return "ghost or its spawn is out of bounds";
+        if (ghost.dx < -1 || ghost.dx > 1 || ghost.dy < -1 || ghost.dy > 1) return "ghost direction out of range";
+    }
+    if (!state.timers.isConsistent()) return "timer wheel is corrupt";
+    bool badTimer = false;
+    state.timers.forEachPending([&](TimerEvent event, std::uint8_t arg) {
+        if (event == TimerEvent::GhostRespawn && arg >= state.ghostCount) badTimer = true;
+    });
+    if (badTimer) return "respawn timer for a ghost that does not exist";
+
+    int pellets = 0, pacmanCells = 0;
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        for (int x = 0; x < MAP_WIDTH; ++x) {
+            CellType cell = state.board[y][x];
+            if (cell > CellType::Ghost) return "unknown cell type on the board";
+            if (cell == CellType::Pellet || cell == CellType::PowerPellet) pellets++;
+            if (cell == CellType::Pacman) pacmanCells++;
+        }
+    }
+    if (pellets != state.pellets) return "pellet count does not match the board";
+    if (pacmanCells != 1) return "board does not have exactly one Pacman cell";
+    if (!isWalkable(state, state.pacmanX, state.pacmanY)) return "Pacman is out of bounds or inside a wall";
+    if (state.board[state.pacmanY][state.pacmanX] != CellType::Pacman) return "Pacman cell is not where Pacman is";
+    for (int i = 0; i < state.ghostCount; ++i) {
+        if (!levelStart && !isWalkable(state, state.ghosts[i].x, state.ghosts[i].y)) return "ghost is inside a wall";
+    }
+    if (state.powerTimer && !state.timers.isPending(state.powerTimer)) return "power mode without a pending timer";
+    if (state.lives < 0 || state.lives > rules.lives) return "lives out of range";
+    if (state.score < 0) return "negative score";
+    return nullptr;
+}
+
+inline void addSimGhost(SimState &state, int x, int y, char number) {
+    if (state.ghostCount < MAX_GHOSTS) {
+        state.ghosts[state.ghostCount++] = SimGhost{static_cast<std::int16_t>(x), static_cast<std::int16_t>(y), 0, 0, number,
+                                                    false, static_cast<std::int16_t>(x), static_cast<std::int16_t>(y)};
+    }
+}
+
+// Build a state from a map sketch: '#' wall, '.' pellet, 'o' power pellet,
+// 'P' Pacman, '1'-'9' a ghost start; anything else is open path
+inline SimState loadSimState(const std::array<std::string, MAP_HEIGHT> &sketch, const GameRules &rules = GameRules()) {
+    SimState state{};
+    state.lives = rules.lives;
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        for (int x = 0; x < MAP_WIDTH; ++x) {
+            char ch = x < static_cast<int>(sketch[y].size()) ? sketch[y][x] : ' ';
+            if (x >= rules.columns) ch = '#';
+            switch (ch) {
+                case '#':
+                    state.board[y][x] = CellType::Wall;
+                    break;
+                case '.':
+                case 'o':
+                    if (rules.pellets) {
+                        state.board[y][x] = ch == '.' ? CellType::Pellet : CellType::PowerPellet;
+                        state.pellets++;
+                    } else {
+                        state.board[y][x] = CellType::Path;
+                    }
+                    break;
+                case 'P':
+                    state.board[y][x] = CellType::Pacman;
+                    state.pacmanX = state.spawnX = x;
+                    state.pacmanY = state.spawnY = y;
+                    break;
+                default:
+                    state.board[y][x] = CellType::Path;
+                    if (ch >= '1' && ch <= '9') addSimGhost(state, x, y, ch);
+                    break;
+            }
+        }
+    }
+    return state;
+}
+
+// Move Pacman one cell if the target is open, eating whatever is there
+inline void stepPacman(SimState &state, Direction direction, const GameRules &rules = GameRules()) {
+    if (direction == Direction::Stay) return;
+    int newX = state.pacmanX + DIRECTION_DX[static_cast<int>(direction)];
+    int newY = state.pacmanY + DIRECTION_DY[static_cast<int>(direction)];
+    if (!isWalkable(state, newX, newY)) return;
+
+    state.board[state.pacmanY][state.pacmanX] = CellType::Path;
+    state.pacmanX = newX;
+    state.pacmanY = newY;
+
+    CellType &cell = state.board[newY][newX];
+    if (cell == CellType::Pellet) {
+        state.score += rules.pelletScore;
+        state.pellets--;
+    } else if (cell == CellType::PowerPellet) {
+        state.score += rules.powerPelletScore;
+        state.pellets--;
+        if (rules.powerTicks > 0) {
+            // A second power pellet restarts the countdown
+            if (state.powerTimer) state.timers.cancel(state.powerTimer);
+            state.powerTimer = state.timers.schedule(static_cast<std::uint32_t>(rules.powerTicks), TimerEvent::PowerEnd);
+        }
+    }
+    cell = CellType::Pacman;
+}
+
+// Returns true when a ghost caught Pacman and a life was lost. In power
+// mode Pacman eats the ghost instead and it leaves the board for a while.
+inline bool stepCollision(SimState &state, const GameRules &rules = GameRules()) {
+    if (!rules.ghostsKill) return false;
+    for (int i = 0; i < state.ghostCount; ++i) {
+        SimGhost &ghost = state.ghosts[i];
+        if (ghost.eaten || ghost.x != state.pacmanX || ghost.y != state.pacmanY) continue;
+        if (state.powerTimer) {
+            state.score += rules.ghostScore;
+            // With every timer taken the ghost just stays on the board
+            ghost.eaten = state.timers.schedule(static_cast<std::uint32_t>(std::max(rules.ghostRespawnTicks, 1)),
+                                                TimerEvent::GhostRespawn, static_cast<std::uint8_t>(i)) != 0;
+            continue;
+        }
+        state.lives--;
+        if (state.lives > 0 && rules.respawnAfterHit) {
+            state.board[state.pacmanY][state.pacmanX] = CellType::Path;
+            state.pacmanX = state.spawnX;
+            state.pacmanY = state.spawnY;
+            state.board[state.pacmanY][state.pacmanX] = CellType::Pacman;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Ghosts keep going until blocked, then turn to a random open exit chosen
+// with the ghost's draw for this tick
+inline void stepGhost(const SimState &state, SimGhost &ghost, std::uint32_t random) {
+    if (ghost.eaten) return;
+    int newX = ghost.x + ghost.dx;
+    int newY = ghost.y + ghost.dy;
+
+    if ((ghost.dx == 0 && ghost.dy == 0) || !isWalkable(state, newX, newY)) {
+        std::uint8_t exits = cellExits(state, ghost.x, ghost.y);
+        if (!exits) return;
+
+        int direction = static_cast<int>(pickExit(exits, random));
+        ghost.dx = static_cast<std::int8_t>(DIRECTION_DX[direction]);
+        ghost.dy = static_cast<std::int8_t>(DIRECTION_DY[direction]);
+        newX = ghost.x + ghost.dx;
+        newY = ghost.y + ghost.dy;
+    }
+
+    ghost.x = static_cast<std::int16_t>(newX);
+    ghost.y = static_cast<std::int16_t>(newY);
+}
+
+// What a timer does when it fires
+inline void fireSimTimer(SimState &state, TimerEvent event, std::uint8_t arg) {
+    switch (event) {
+        case TimerEvent::PowerEnd:
+            state.powerTimer = 0;
+            break;
+        case TimerEvent::GhostRespawn: {
+            SimGhost &ghost = state.ghosts[arg];
+            ghost.eaten = false;
+            ghost.x = ghost.spawnX;
+            ghost.y = ghost.spawnY;
+            ghost.dx = ghost.dy = 0;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// One game tick: due timers fire, Pacman moves, collisions are checked,
+// then the ghosts move. The ghosts' randomness is keyed by seed, the tick
+// and the ghost slot (see counter_rng.h), so the result depends only on the
+// state, the direction and the seed.
+inline void stepSimState(SimState &state, Direction direction, std::uint64_t seed, const GameRules &rules = GameRules()) {
+    state.timers.advance([&state](TimerEvent event, std::uint8_t arg) { fireSimTimer(state, event, arg); });
+    stepPacman(state, direction, rules);
+    stepCollision(state, rules);
+    if (rules.ghostsMove) {
+        std::uint32_t turns[MAX_GHOSTS];
+        fillRandom(seed, state.tick, RandomPurpose::GhostTurn, 0, turns, static_cast<std::size_t>(state.ghostCount));
+        for (int i = 0; i < state.ghostCount; ++i) {
+            stepGhost(state, state.ghosts[i], turns[i]);
+        }
+    }
+    state.tick++;
+}
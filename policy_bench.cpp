@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "engine.h"
+#include "headless_frontend.h"
+
+// Runs every threading policy on the same map, ghost seed and scripted
+// input with no frame or tick pacing, and reports how fast each one ticks
+// and draws and how long a tick takes to reach a presented frame
+// (step-to-present). The script is read on the stepping thread, so the
+// input thread's handoff to the sim is not part of that latency.
+//
+// Usage: policy_bench [--ticks N] [--seed S] [--no-render] [--pack FILE] [--record FILE] [--record-block]
+//   --record FILE   also record each policy's frames to FILE (overwritten per
+//                   policy) to see what capture costs the render thread
+
+template <typename Policy>
+void benchmark(const char *name, const EngineConfig &config, bool render) {
+    HeadlessFrontend frontend(config.seed, render);
+    frontend.record(config.capture);
+    Engine<Policy> engine(config);
+
+    auto start = EngineClock::now();
+    engine.run(frontend);
+    double seconds = std::chrono::duration<double>(EngineClock::now() - start).count();
+
+    LatencyStats latency = frontend.latency();
+    std::cout << name << ": " << static_cast<long>(engine.session().ticks() / seconds) << " ticks/s, "
+              << static_cast<long>(frontend.frames() / seconds) << " frames/s, step-to-present mean "
+              << latency.meanMilliseconds << " ms, p99 " << latency.p99Milliseconds << " ms ("
+              << engine.session().ticks() << " ticks, " << engine.session().games() << " games)" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    EngineConfig config;
+    config.map = CLASSIC_MAP;
+    config.ghosts.assign(std::begin(CLASSIC_GHOSTS), std::end(CLASSIC_GHOSTS));
+    config.tickMilliseconds = 0;
+    config.frameMilliseconds = 0;
+    config.inputMilliseconds = 0;
+    config.maxTicks = 5000;
+    config.restartOnFinish = true;
+    config.seed = 1;
+    bool render = true;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) config.maxTicks = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--no-render") == 0) render = false;
+        else if (std::strcmp(argv[i], "--pack") == 0 && hasValue) {
+            auto pack = std::make_shared<LevelPack>();
+            if (!pack->open(argv[++i], config.rules)) return -1;
+            config.levelPack = pack;
+        }
+        else if (std::strcmp(argv[i], "--record") == 0 && hasValue) config.capture.rawPath = argv[++i];
+        else if (std::strcmp(argv[i], "--record-block") == 0) config.capture.blockWhenFull = true;
+        else {
+            std::cerr << "Unknown or incomplete option " << argv[i] << std::endl;
+            return -1;
+        }
+    }
+
+    config.scriptedInput = true;
+    config.scriptSeed = config.seed;
+
+    benchmark<SingleThreaded>("SingleThreaded", config, render);
+    benchmark<SplitThreads>("SplitThreads", config, render);
+    benchmark<JobThreads>("JobThreads", config, render);
+    return 0;
+}
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+// Pixel buffer objects are OpenGL 2.1; link with -lGL
+#define GL_GLEXT_PROTOTYPES
+#include <SFML/OpenGL.hpp>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "engine.h"
+
+// Xlib defines macros such as None and Status, so it comes after SFML and
+// the engine headers; include this header last
+#include <X11/Xlib.h>  // Include Xlib for XInitThreads
+
+constexpr int TILE_SIZE = 30;
+
+// Everything that differs between the builds on the window side
+struct SfmlStyle {
+    const char *title = "SFML Maze Game";
+    const char *fontPath = "arial.ttf";      // nullptr when nothing draws text
+    int columns = MAP_WIDTH;                 // How many columns get drawn
+    sf::Color wallColor = sf::Color::Blue;
+    std::array<sf::Color, 3> ghostColors = {sf::Color::Red, sf::Color::Blue, sf::Color::Cyan};
+    sf::Color frightenedColor = sf::Color::White;  // Every ghost while Pacman is in power mode
+    float pelletRadius = TILE_SIZE / 6;
+    float powerPelletRadius = TILE_SIZE / 3;
+    sf::Color powerPelletColor = sf::Color::Magenta;
+    bool hud = true;
+    sf::Vector2f scorePosition{10, 10};
+    sf::Vector2f livesPosition{10, 40};
+    bool wasd = false;                       // WASD instead of the arrow keys
+    bool realtimeKeys = true;                // Poll held keys instead of reacting to key presses
+    bool resultScreens = true;               // "Game Over" / "You Won" at the end
+};
+
+// Reads finished frames back from the GPU without stalling the render
+// thread. glReadPixels into a pixel buffer object only queues the copy and
+// returns; each buffer is mapped DEPTH frames later, by when the copy has
+// long completed, and its rows are handed to the capture writer. Needs the
+// window's GL context to be current, so it runs on the render thread.
+class AsyncReadback {
+public:
+    static constexpr int DEPTH = 3;
+    static constexpr int SLOTS = DEPTH + 1;  // One spare, so a read is issued before the oldest is collected
+
+    void open(int width, int height) {
+        width_ = width;
+        height_ = height;
+        glGenBuffers(SLOTS, buffers_);
+        for (GLuint buffer : buffers_) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(width) * height * 3, nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        issued_ = 0;
+    }
+
+    // Queues the back buffer of this frame, then passes on the one read
+    // DEPTH frames ago. The capture overhead counts from before the read
+    // is issued, so it covers the readback as well as the map and copy.
+    void readFrame(FrameCapture &capture) {
+        auto started = std::chrono::steady_clock::now();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers_[issued_ % SLOTS]);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadBuffer(GL_BACK);
+        glReadPixels(0, 0, width_, height_, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        issued_++;
+        if (issued_ > DEPTH) collect(static_cast<int>((issued_ - 1 - DEPTH) % SLOTS), capture, started);
+    }
+
+    // Passes on the frames still in flight and frees the buffers
+    void close(FrameCapture &capture) {
+        for (std::uint64_t frame = issued_ > DEPTH ? issued_ - DEPTH : 0; frame < issued_; ++frame) {
+            collect(static_cast<int>(frame % SLOTS), capture, std::chrono::steady_clock::now());
+        }
+        glDeleteBuffers(SLOTS, buffers_);
+        issued_ = 0;
+    }
+
+private:
+    void collect(int slot, FrameCapture &capture, std::chrono::steady_clock::time_point started) {
+        Framebuffer *frame = capture.acquire(started);
+        if (!frame) return;  // Skipped or dropped; no need to map anything
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers_[slot]);
+        const auto *pixels = static_cast<const unsigned char *>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+        if (pixels && frame->width == width_ && frame->height == height_) {
+            // GL rows run bottom to top
+            std::size_t rowBytes = static_cast<std::size_t>(width_) * 3;
+            for (int row = 0; row < height_; ++row) {
+                std::memcpy(&frame->pixels[static_cast<std::size_t>(height_ - 1 - row) * width_], pixels + row * rowBytes, rowBytes);
+            }
+        }
+        if (pixels) glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        capture.submit(frame);
+    }
+
+    GLuint buffers_[SLOTS] = {};
+    int width_ = 0, height_ = 0;
+    std::uint64_t issued_ = 0;
+};
+
+class SfmlFrontend {
+public:
+    explicit SfmlFrontend(const SfmlStyle &style) : style_(style) {
+        // Input, simulation and rendering may run on different threads
+        XInitThreads();
+    }
+
+    // Records every presented frame through an AsyncReadback
+    void record(const CaptureConfig &capture) { captureConfig_ = capture; }
+
+    bool open() {
+        if (style_.fontPath && !font_.loadFromFile(style_.fontPath)) {
+            std::cerr << "Failed to load font " << style_.fontPath << ". Ensure the file is in the correct directory." << std::endl;
+            return false;
+        }
+        window_.create(sf::VideoMode(MAP_WIDTH * TILE_SIZE, MAP_HEIGHT * TILE_SIZE), style_.title);
+        initShapes();
+        if (captureConfig_.enabled()) {
+            capture_.reset(new FrameCapture(captureConfig_, MAP_WIDTH * TILE_SIZE, MAP_HEIGHT * TILE_SIZE));
+            if (!capture_->open()) return false;
+            readback_.open(MAP_WIDTH * TILE_SIZE, MAP_HEIGHT * TILE_SIZE);
+        }
+        return true;
+    }
+
+    bool isOpen() const { return window_.isOpen(); }
+
+    void processEvents(InputState &input) {
+        sf::Event event;
+        while (window_.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                input.quit = true;
+                window_.close();
+            }
+            if (event.type == sf::Event::KeyPressed && !style_.realtimeKeys) {
+                Direction direction = directionForKey(event.key.code);
+                if (direction != Direction::Stay) input.press(direction);
+            }
+        }
+    }
+
+    void pollInput(InputState &input, const SimState &) {
+        if (!style_.realtimeKeys) return;
+        const sf::Keyboard::Key keys[4] = {upKey(), downKey(), leftKey(), rightKey()};
+        for (int d = 0; d < 4; ++d) {
+            if (sf::Keyboard::isKeyPressed(keys[d])) input.held = static_cast<Direction>(d);
+        }
+    }
+
+    void draw(const GameSnapshot &snapshot) {
+        const SimState &state = snapshot.state;
+        window_.clear(sf::Color::Black);
+
+        for (int y = 0; y < MAP_HEIGHT; ++y) {
+            for (int x = 0; x < style_.columns; ++x) {
+                drawGameElements(x, y, state.board[y][x]);
+            }
+        }
+        for (int i = 0; i < state.ghostCount; ++i) {
+            const SimGhost &ghost = state.ghosts[i];
+            if (ghost.eaten) continue;
+            drawGhost(ghost.x, ghost.y, state.powerTimer ? style_.frightenedColor : getGhostColor(ghost.number));
+        }
+        drawPacman(state.pacmanX, state.pacmanY);
+
+        if (style_.hud && style_.fontPath) {
+            window_.draw(scoreText_);
+            window_.draw(livesText_);
+            drawNumber(state.score, style_.scorePosition.x + scoreText_.getLocalBounds().width, style_.scorePosition.y);
+            drawNumber(state.lives, style_.livesPosition.x + livesText_.getLocalBounds().width, style_.livesPosition.y);
+        }
+    }
+
+    void present() {
+        if (capture_) readback_.readFrame(*capture_);
+        window_.display();
+    }
+
+    void finish(const GameSnapshot &snapshot, bool gameEnded) {
+        if (gameEnded && style_.resultScreens && style_.fontPath && window_.isOpen()) {
+            if (snapshot.state.lives <= 0) {
+                drawResultScreen("Game Over!\nFinal Score: " + std::to_string(snapshot.state.score), sf::Color::Red);
+            } else {
+                drawResultScreen("You Won!\nFinal Score: " + std::to_string(snapshot.state.score), sf::Color::Green);
+            }
+        }
+        if (capture_) {
+            readback_.close(*capture_);
+            capture_.reset();  // Drains the writer and prints its stats
+        }
+        if (window_.isOpen()) window_.close();
+    }
+
+private:
+    sf::Keyboard::Key upKey() const { return style_.wasd ? sf::Keyboard::W : sf::Keyboard::Up; }
+    sf::Keyboard::Key downKey() const { return style_.wasd ? sf::Keyboard::S : sf::Keyboard::Down; }
+    sf::Keyboard::Key leftKey() const { return style_.wasd ? sf::Keyboard::A : sf::Keyboard::Left; }
+    sf::Keyboard::Key rightKey() const { return style_.wasd ? sf::Keyboard::D : sf::Keyboard::Right; }
+
+    Direction directionForKey(sf::Keyboard::Key key) const {
+        if (key == upKey()) return Direction::Up;
+        if (key == downKey()) return Direction::Down;
+        if (key == leftKey()) return Direction::Left;
+        if (key == rightKey()) return Direction::Right;
+        return Direction::Stay;
+    }
+
+    sf::Color getGhostColor(char number) const {
+        if (number >= '1' && number <= '3') return style_.ghostColors[number - '1'];
+        return sf::Color::White;
+    }
+
+    // Shapes are built once and only moved/recoloured while drawing, so a
+    // frame does not construct fresh SFML geometry (and allocate) per cell
+    void initShapes() {
+        tileShape_.setSize(sf::Vector2f(TILE_SIZE, TILE_SIZE));
+        pelletShape_.setRadius(style_.pelletRadius);
+        pelletShape_.setFillColor(sf::Color::Yellow);
+        powerPelletShape_.setRadius(style_.powerPelletRadius);
+        powerPelletShape_.setFillColor(style_.powerPelletColor);
+        pacmanShape_.setRadius(TILE_SIZE / 3);
+        pacmanShape_.setFillColor(sf::Color::Yellow);
+        ghostHeadShape_.setRadius(TILE_SIZE / 4);
+        ghostBodyShape_.setSize(sf::Vector2f(TILE_SIZE / 2, TILE_SIZE / 2));
+
+        // The labels never change, only the numbers after them, which are
+        // drawn glyph by glyph so no string is rebuilt per frame
+        for (sf::Text *text : {&scoreText_, &livesText_}) {
+            text->setFont(font_);
+            text->setCharacterSize(24);
+            text->setFillColor(sf::Color::White);
+        }
+        scoreText_.setString("Score: ");
+        scoreText_.setPosition(style_.scorePosition);
+        livesText_.setString("Lives: ");
+        livesText_.setPosition(style_.livesPosition);
+        for (int d = 0; d < 10; ++d) {
+            const char glyph[2] = {static_cast<char>('0' + d), '\0'};
+            digitTexts_[d].setFont(font_);
+            digitTexts_[d].setCharacterSize(24);
+            digitTexts_[d].setFillColor(sf::Color::White);
+            digitTexts_[d].setString(glyph);
+        }
+    }
+
+    void drawGameElements(int x, int y, CellType type) {
+        if (type == CellType::Wall) {
+            tileShape_.setPosition(x * TILE_SIZE, y * TILE_SIZE);
+            tileShape_.setFillColor(style_.wallColor);
+            window_.draw(tileShape_);
+        } else if (type == CellType::Pellet) {
+            float radius = pelletShape_.getRadius();
+            pelletShape_.setPosition((x + 0.5f) * TILE_SIZE - radius, (y + 0.5f) * TILE_SIZE - radius);
+            window_.draw(pelletShape_);
+        } else if (type == CellType::PowerPellet) {
+            float radius = powerPelletShape_.getRadius();
+            powerPelletShape_.setPosition((x + 0.5f) * TILE_SIZE - radius, (y + 0.5f) * TILE_SIZE - radius);
+            window_.draw(powerPelletShape_);
+        }
+    }
+
+    void drawGhost(int x, int y, sf::Color color) {
+        ghostHeadShape_.setFillColor(color);
+        ghostHeadShape_.setPosition(x * TILE_SIZE + TILE_SIZE / 4, y * TILE_SIZE + TILE_SIZE / 8);
+        ghostBodyShape_.setFillColor(color);
+        ghostBodyShape_.setPosition(x * TILE_SIZE + TILE_SIZE / 4, y * TILE_SIZE + TILE_SIZE * 3 / 8);
+        window_.draw(ghostHeadShape_);
+        window_.draw(ghostBodyShape_);
+    }
+
+    void drawPacman(int x, int y) {
+        pacmanShape_.setPosition(x * TILE_SIZE + TILE_SIZE / 3, y * TILE_SIZE + TILE_SIZE / 3);
+        window_.draw(pacmanShape_);
+    }
+
+    // Draws a non-negative number from the prebuilt digit texts
+    void drawNumber(int value, float x, float y) {
+        int digits[12];
+        int count = 0;
+        do {
+            digits[count++] = value % 10;
+            value /= 10;
+        } while (value > 0 && count < 12);
+
+        const float advance = 24 * 0.6f;
+        for (int i = count - 1; i >= 0; --i) {
+            sf::Text &glyph = digitTexts_[digits[i]];
+            glyph.setPosition(x, y);
+            window_.draw(glyph);
+            x += advance;
+        }
+    }
+
+    void drawResultScreen(const std::string &message, sf::Color color) {
+        sf::Text text(message, font_, 50);
+        text.setFillColor(color);
+        text.setStyle(sf::Text::Bold);
+
+        sf::FloatRect textRect = text.getLocalBounds();
+        text.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
+        text.setPosition(sf::Vector2f(window_.getSize().x / 2.0f, window_.getSize().y / 2.0f));
+
+        window_.clear();
+        window_.draw(text);
+        window_.display();
+
+        sf::sleep(sf::seconds(5)); // Display for 5 seconds
+    }
+
+    SfmlStyle style_;
+    sf::RenderWindow window_;
+    sf::Font font_;
+
+    sf::RectangleShape tileShape_;
+    sf::CircleShape pelletShape_;
+    sf::CircleShape powerPelletShape_;
+    sf::CircleShape pacmanShape_;
+    sf::CircleShape ghostHeadShape_;
+    sf::RectangleShape ghostBodyShape_;
+    sf::Text scoreText_;
+    sf::Text livesText_;
+    std::array<sf::Text, 10> digitTexts_;
+
+    CaptureConfig captureConfig_;
+    std::unique_ptr<FrameCapture> capture_;
+    AsyncReadback readback_;
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "pacman_sim.h"
+
+// Software rasterizer for headless runs. It draws the same scene as the
+// threaded build's renderingThread (tiles, pellets, ghosts, Pacman and the
+// score/lives HUD) into a plain RGB framebuffer, so frames can be produced
+// and compared on machines with no display or X server.
+
+struct Rgb {
+    std::uint8_t r, g, b;
+};
+
+namespace SoftColor {
+constexpr Rgb Black{0, 0, 0};
+constexpr Rgb White{255, 255, 255};
+constexpr Rgb Red{255, 0, 0};
+constexpr Rgb Blue{0, 0, 255};
+constexpr Rgb Cyan{0, 255, 255};
+constexpr Rgb Yellow{255, 255, 0};
+constexpr Rgb Magenta{255, 0, 255};
+}
+
+struct Framebuffer {
+    int width = 0, height = 0;
+    std::vector<Rgb> pixels;
+
+    Framebuffer(int w, int h) : width(w), height(h), pixels(static_cast<std::size_t>(w) * h) {}
+
+    void clear(Rgb color) { std::fill(pixels.begin(), pixels.end(), color); }
+
+    void fillRect(int x, int y, int w, int h, Rgb color) {
+        int x0 = std::max(x, 0), y0 = std::max(y, 0);
+        int x1 = std::min(x + w, width), y1 = std::min(y + h, height);
+        for (int row = y0; row < y1; ++row) {
+            Rgb *line = &pixels[static_cast<std::size_t>(row) * width];
+            std::fill(line + x0, line + x1, color);
+        }
+    }
+
+    // Like sf::CircleShape: (x, y) is the top-left corner of the bounding box
+    void fillCircle(float x, float y, float radius, Rgb color) {
+        float cx = x + radius, cy = y + radius;
+        int y0 = std::max(static_cast<int>(std::floor(y)), 0);
+        int y1 = std::min(static_cast<int>(std::ceil(y + 2 * radius)), height);
+        for (int row = y0; row < y1; ++row) {
+            float dy = row + 0.5f - cy;
+            float span = radius * radius - dy * dy;
+            if (span <= 0) continue;
+            float half = std::sqrt(span);
+            int x0 = std::max(static_cast<int>(std::lround(cx - half)), 0);
+            int x1 = std::min(static_cast<int>(std::lround(cx + half)), width);
+            Rgb *line = &pixels[static_cast<std::size_t>(row) * width];
+            if (x0 < x1) std::fill(line + x0, line + x1, color);
+        }
+    }
+};
+
+// 5x7 bitmap glyphs for the HUD; each byte is one row, low 5 bits used
+inline const std::uint8_t *hudGlyph(char ch) {
+    static const std::uint8_t digits[10][7] = {
+        {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},
+        {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},
+        {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},
+        {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},
+        {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},
+    };
+    static const std::uint8_t letterS[7] = {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E};
+    static const std::uint8_t letterC[7] = {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E};
+    static const std::uint8_t letterO[7] = {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E};
+    static const std::uint8_t letterR[7] = {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11};
+    static const std::uint8_t letterE[7] = {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F};
+    static const std::uint8_t letterL[7] = {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F};
+    static const std::uint8_t letterI[7] = {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E};
+    static const std::uint8_t letterV[7] = {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04};
+    static const std::uint8_t colon[7] = {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00};
+
+    if (ch >= '0' && ch <= '9') return digits[ch - '0'];
+    switch (ch) {
+        case 'S': return letterS;
+        case 'C': return letterC;
+        case 'O': return letterO;
+        case 'R': return letterR;
+        case 'E': return letterE;
+        case 'L': return letterL;
+        case 'I': return letterI;
+        case 'V': return letterV;
+        case ':': return colon;
+        default: return nullptr; // Space and anything unknown
+    }
+}
+
+class SoftRenderer {
+public:
+    explicit SoftRenderer(int tileSize = 30)
+        : tileSize_(tileSize), frame_(MAP_WIDTH * tileSize, MAP_HEIGHT * tileSize) {}
+
+    const Framebuffer &frame() const { return frame_; }
+
+    // Same draw order as renderingThread: board, ghosts, Pacman, HUD
+    void render(const SimState &state) {
+        frame_.clear(SoftColor::Black);
+        for (int y = 0; y < MAP_HEIGHT; ++y) {
+            for (int x = 0; x < MAP_WIDTH; ++x) {
+                drawCell(x, y, state.board[y][x]);
+            }
+        }
+        for (int i = 0; i < state.ghostCount; ++i) {
+            const SimGhost &ghost = state.ghosts[i];
+            // Eaten ghosts are off the board; in power mode they all turn white
+            if (ghost.eaten) continue;
+            drawGhost(ghost.x, ghost.y, state.powerTimer ? SoftColor::White : ghostColor(ghost.number));
+        }
+        drawPacman(state.pacmanX, state.pacmanY);
+
+        drawText("SCORE:", 10, 10);
+        drawNumber(state.score, 10 + 7 * HUD_ADVANCE, 10);
+        drawText("LIVES:", 10, 40);
+        drawNumber(state.lives, 10 + 7 * HUD_ADVANCE, 40);
+    }
+
+private:
+    static constexpr int HUD_SCALE = 3;
+    static constexpr int HUD_ADVANCE = 6 * HUD_SCALE;
+
+    static Rgb ghostColor(char number) {
+        switch (number) {
+            case '1': return SoftColor::Red;
+            case '2': return SoftColor::Blue;
+            case '3': return SoftColor::Cyan;
+            default: return SoftColor::White;
+        }
+    }
+
+    void drawCell(int x, int y, CellType type) {
+        const float tile = static_cast<float>(tileSize_);
+        if (type == CellType::Wall) {
+            frame_.fillRect(x * tileSize_, y * tileSize_, tileSize_, tileSize_, SoftColor::Blue);
+        } else if (type == CellType::Pellet) {
+            float radius = static_cast<float>(tileSize_ / 6);
+            frame_.fillCircle((x + 0.5f) * tile - radius, (y + 0.5f) * tile - radius, radius, SoftColor::Yellow);
+        } else if (type == CellType::PowerPellet) {
+            float radius = static_cast<float>(tileSize_ / 3);
+            frame_.fillCircle((x + 0.5f) * tile - radius, (y + 0.5f) * tile - radius, radius, SoftColor::Magenta);
+        }
+    }
+
+    void drawGhost(int x, int y, Rgb color) {
+        frame_.fillCircle(static_cast<float>(x * tileSize_ + tileSize_ / 4), static_cast<float>(y * tileSize_ + tileSize_ / 8),
+                          static_cast<float>(tileSize_ / 4), color);
+        frame_.fillRect(x * tileSize_ + tileSize_ / 4, y * tileSize_ + tileSize_ * 3 / 8, tileSize_ / 2, tileSize_ / 2, color);
+    }
+
+    void drawPacman(int x, int y) {
+        frame_.fillCircle(static_cast<float>(x * tileSize_ + tileSize_ / 3), static_cast<float>(y * tileSize_ + tileSize_ / 3),
+                          static_cast<float>(tileSize_ / 3), SoftColor::Yellow);
+    }
+
+    void drawText(const char *text, int x, int y) {
+        for (; *text; ++text, x += HUD_ADVANCE) {
+            const std::uint8_t *glyph = hudGlyph(*text);
+            if (!glyph) continue;
+            for (int row = 0; row < 7; ++row) {
+                for (int col = 0; col < 5; ++col) {
+                    if (glyph[row] & (0x10 >> col)) {
+                        frame_.fillRect(x + col * HUD_SCALE, y + row * HUD_SCALE, HUD_SCALE, HUD_SCALE, SoftColor::White);
+                    }
+                }
+            }
+        }
+    }
+
+    void drawNumber(int value, int x, int y) {
+        char digits[12];
+        std::snprintf(digits, sizeof(digits), "%d", value);
+        drawText(digits, x, y);
+    }
+
+    int tileSize_;
+    Framebuffer frame_;
+};
+
+// Binary PPM (P6), viewable and diffable with any image tool
+inline bool writePpm(const Framebuffer &frame, const std::string &path) {
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    std::fprintf(file, "P6\n%d %d\n255\n", frame.width, frame.height);
+    bool ok = std::fwrite(frame.pixels.data(), sizeof(Rgb), frame.pixels.size(), file) == frame.pixels.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// Appends one frame of packed RGB24 to an open stream, e.g. for
+// `ffmpeg -f rawvideo -pix_fmt rgb24 -s 1230x660 -i frames.raw`
+inline bool writeRawFrame(const Framebuffer &frame, std::FILE *file) {
+    return std::fwrite(frame.pixels.data(), sizeof(Rgb), frame.pixels.size(), file) == frame.pixels.size();
+}
+
+static_assert(sizeof(Rgb) == 3, "Rgb must be tightly packed for the frame writers");
@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "engine.h"
+#include "headless_frontend.h"
+
+// Soak test for the threaded engine. Synthetic input replaces the keyboard
+// (a per-tick script, or random keys the input thread polls), nothing sleeps,
+// games restart back to back, and the state is checked after every tick.
+// A violated invariant aborts with the tick and what was wrong.
+//
+// The default script is read by the stepping thread itself, so it bypasses
+// the input thread and the input-to-sim handoff; only --random exercises
+// that handoff, at the cost of runs that differ from one to the next.
+//
+// Usage: stress [--games N] [--policy split|job|single] [--random] [--seed S] [--render]
+//   --random  fresh random direction on every input poll, through the
+//             input thread, instead of the repeatable per-tick script
+//   --render  also rasterise every frame (off by default to stress the
+//             threads rather than the renderer)
+//
+// Build with -fsanitize=thread to run the same load under ThreadSanitizer;
+// it is slower there, so lower --games.
+
+template <typename Policy>
+int soak(const EngineConfig &config, bool render, bool randomInput) {
+    HeadlessFrontend frontend(config.seed, render, randomInput, 0);
+    Engine<Policy> engine(config);
+
+    auto start = EngineClock::now();
+    engine.run(frontend);
+    double seconds = std::chrono::duration<double>(EngineClock::now() - start).count();
+
+    GameSession &session = engine.session();
+    std::cout << session.finishedGames() << " games (" << session.wins() << " won) in " << seconds << " s: "
+              << static_cast<long>(session.finishedGames() / seconds) << " games/s, "
+              << static_cast<long>(session.ticks() / seconds) << " ticks/s, " << frontend.frames() << " frames, "
+              << session.ticks() << " ticks checked" << std::endl;
+    return session.finishedGames() >= config.maxGames ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    EngineConfig config;
+    config.map = CLASSIC_MAP;
+    config.ghosts.assign(std::begin(CLASSIC_GHOSTS), std::end(CLASSIC_GHOSTS));
+    config.tickMilliseconds = 0;
+    config.frameMilliseconds = 0;
+    config.inputMilliseconds = 0;
+    config.maxGames = 5000;
+    config.restartOnFinish = true;
+    config.checkInvariants = true;
+    config.seed = 1;
+    const char *policy = "split";
+    bool render = false, randomInput = false;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--games") == 0 && hasValue) config.maxGames = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--policy") == 0 && hasValue) policy = argv[++i];
+        else if (std::strcmp(argv[i], "--random") == 0) randomInput = true;
+        else if (std::strcmp(argv[i], "--render") == 0) render = true;
+        else {
+            std::cerr << "Unknown or incomplete option " << argv[i] << std::endl;
+            return -1;
+        }
+    }
+    if (config.maxGames == 0) config.maxGames = 1;
+    config.scriptedInput = !randomInput;
+    config.scriptSeed = config.seed;
+
+    if (std::strcmp(policy, "split") == 0) return soak<SplitThreads>(config, render, randomInput);
+    if (std::strcmp(policy, "job") == 0) return soak<JobThreads>(config, render, randomInput);
+    if (std::strcmp(policy, "single") == 0) return soak<SingleThreaded>(config, render, randomInput);
+    std::cerr << "Unknown policy " << policy << std::endl;
+    return -1;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "trace.h"
+
+// Where and how the engine's threads run, and how periodic loops sleep.
+// Everything defaults to "leave it to the OS", which is what the original
+// builds did.
+
+struct ThreadPlacement {
+    int cpu = -1;          // Pin to this CPU; -1 = anywhere
+    int fifoPriority = 0;  // SCHED_FIFO priority (1-99); 0 = normal scheduling
+};
+
+struct SchedulingConfig {
+    ThreadPlacement sim;     // gameStateUpdateThread, JobThreads workers, the SingleThreaded loop
+    ThreadPlacement render;  // renderingThread, the JobThreads main loop
+    ThreadPlacement input;   // inputHandlingThread
+    bool absoluteDeadlines = false; // Fixed-rate grid with clock_nanosleep(TIMER_ABSTIME), see PeriodPacer
+    bool jitterReport = false;      // Print how late each tick started
+};
+
+// Applies a placement to the calling thread. Failures (a CPU number out of
+// range or not present, no permission for SCHED_FIFO) are reported and the
+// thread carries on with normal scheduling.
+inline void applyThreadPlacement(const char *threadName, const ThreadPlacement &placement) {
+    if (placement.cpu < -1 || placement.cpu >= CPU_SETSIZE) {
+        // CPU_SET has no bounds check of its own
+        std::cerr << threadName << ": cannot pin to CPU " << placement.cpu << ": outside 0.." << CPU_SETSIZE - 1 << std::endl;
+    } else if (placement.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(placement.cpu, &cpus);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (error != 0) {
+            std::cerr << threadName << ": cannot pin to CPU " << placement.cpu << ": " << std::strerror(error) << std::endl;
+        }
+    }
+    if (placement.fifoPriority > 0) {
+        sched_param param{};
+        param.sched_priority = std::min(placement.fifoPriority, sched_get_priority_max(SCHED_FIFO));
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (error != 0) {
+            std::cerr << threadName << ": SCHED_FIFO " << param.sched_priority << " not permitted (" << std::strerror(error)
+                      << "), staying on normal scheduling" << std::endl;
+        }
+    }
+}
+
+// How far each period's actual start was from its scheduled start, in a
+// fixed histogram of 1 us buckets so recording never allocates
+class JitterStats {
+public:
+    static constexpr int BUCKETS = 20000; // Up to 20 ms; anything later lands in the last bucket
+
+    void record(std::chrono::nanoseconds lateness) {
+        std::int64_t micros = std::max<std::int64_t>(lateness.count(), 0) / 1000;
+        buckets_[std::min<std::int64_t>(micros, BUCKETS - 1)]++;
+        samples_++;
+        sumNanos_ += std::max<std::int64_t>(lateness.count(), 0);
+        maxNanos_ = std::max<std::int64_t>(maxNanos_, lateness.count());
+    }
+
+    void recordMissed(std::uint64_t periods) { missed_ += periods; }
+
+    std::uint64_t samples() const { return samples_; }
+
+    // Upper edge of the bucket holding the given fraction of samples, in us
+    int percentile(double fraction) const {
+        std::uint64_t target = static_cast<std::uint64_t>(fraction * samples_);
+        std::uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets_[i];
+            if (seen > target) return i + 1;
+        }
+        return BUCKETS;
+    }
+
+    void print(const char *name) const {
+        if (samples_ == 0) return;
+        std::printf("%s jitter over %llu periods: mean %.1f us, p50 < %d us, p99 < %d us, p99.9 < %d us, max %.1f us, %llu periods skipped\n",
+                    name, static_cast<unsigned long long>(samples_), sumNanos_ / 1e3 / samples_, percentile(0.5),
+                    percentile(0.99), percentile(0.999), maxNanos_ / 1e3, static_cast<unsigned long long>(missed_));
+    }
+
+private:
+    std::array<std::uint32_t, BUCKETS> buckets_{};
+    std::uint64_t samples_ = 0;
+    std::uint64_t missed_ = 0;
+    std::int64_t sumNanos_ = 0;
+    std::int64_t maxNanos_ = 0;
+};
+
+// Paces a loop to a period, in one of two modes:
+//
+// Relative (default): each wait ends one period after the previous wait
+// returned. Whatever a wake-up is late by pushes every later one back, so
+// the rate drifts below 1/period under load. An iteration that ran longer
+// than the period does not sleep at all.
+//
+// Absolute: waits end on a fixed grid, start + k * period, on
+// CLOCK_MONOTONIC (the clock behind steady_clock on Linux), each with a
+// TIMER_ABSTIME clock_nanosleep, so lateness does not accumulate. After an
+// overrun the loop catches up by at most one period: the grid point that
+// was just missed runs at once (and counts as late), and any whole periods
+// before it are skipped and counted rather than run back to back.
+class PeriodPacer {
+public:
+    PeriodPacer(int milliseconds, bool absolute, JitterStats *jitter = nullptr)
+        : period_(std::chrono::milliseconds(milliseconds)), absolute_(absolute), jitter_(jitter),
+          next_(std::chrono::steady_clock::now()), resumed_(next_) {}
+
+    void wait() {
+        if (period_.count() <= 0) return;
+        auto now = std::chrono::steady_clock::now();
+        if (absolute_) {
+            next_ += period_;
+            if (next_ <= now) {
+                auto behind = (now - next_) / period_;
+                if (jitter_ && behind > 0) jitter_->recordMissed(behind);
+                next_ += behind * period_;
+            }
+        } else {
+            next_ = resumed_ + period_;
+        }
+
+        if (next_ > now) {
+            TraceSpan span("sleep");
+            if (absolute_) {
+                sleepUntil(next_);
+            } else {
+                std::this_thread::sleep_until(next_);
+            }
+            now = std::chrono::steady_clock::now();
+        }
+        resumed_ = now;
+        if (jitter_) jitter_->record(now - next_);
+    }
+
+private:
+    static void sleepUntil(std::chrono::steady_clock::time_point deadline) {
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        timespec target;
+        target.tv_sec = static_cast<time_t>(nanos / 1000000000);
+        target.tv_nsec = static_cast<long>(nanos % 1000000000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+        }
+    }
+
+    std::chrono::nanoseconds period_;
+    bool absolute_;
+    JitterStats *jitter_;
+    std::chrono::steady_clock::time_point next_;     // Deadline of the current wait
+    std::chrono::steady_clock::time_point resumed_;  // When the previous wait returned
+};
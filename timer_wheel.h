@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// Hierarchical timing wheel for timed game events (power mode running out,
+// eaten ghosts coming back). It lives inside SimState, so it is plain data:
+// copying a state copies its pending timers, a zero-filled wheel is an
+// empty one, and stepping a copy fires exactly the same events.
+//
+// Level 0 has one slot per tick for events due within the next 32 ticks,
+// level 1 one slot per 32 ticks and level 2 one slot per 1024 ticks. When
+// the current tick reaches a coarse slot its events cascade down a level,
+// so each tick only looks at the events that are due. Timers sit in
+// intrusive lists over a fixed node pool: scheduling and cancelling are a
+// link and an unlink, with no search and no allocation.
+
+enum class TimerEvent : std::uint8_t { None, PowerEnd, GhostRespawn };
+
+// Refers to one scheduled timer; 0 means none. The low 8 bits are the
+// node number and the high 24 its generation, so a stale id does not match
+// the node's next timers. The generation wraps after 2^24 reuses of one
+// node; an id kept that long could then match again, so drop ids once
+// their timer fires (as SimState does with powerTimer).
+using TimerId = std::uint32_t;
+
+constexpr int TIMER_SLOT_BITS = 5;
+constexpr int TIMER_SLOTS = 1 << TIMER_SLOT_BITS;
+constexpr int TIMER_LEVELS = 3;
+constexpr std::uint32_t TIMER_MAX_DELAY = (1u << (TIMER_SLOT_BITS * TIMER_LEVELS)) - 1;
+constexpr int TIMER_CAPACITY = 16;
+
+constexpr std::uint32_t TIMER_GENERATION_MASK = 0xFFFFFF;
+
+struct TimerNode {
+    std::uint32_t due;
+    std::uint32_t generation;    // Low 24 bits used, bumped on every schedule
+    std::uint8_t next, prev;     // Node numbers (index + 1) in the same list, 0 = none
+    std::uint8_t list;           // level * TIMER_SLOTS + slot while scheduled
+    TimerEvent event;            // None while the node is free
+    std::uint8_t arg;
+
+    bool operator==(const TimerNode &) const = default;
+};
+
+struct TimerWheel {
+    std::uint32_t now;
+    std::array<std::uint8_t, TIMER_LEVELS * TIMER_SLOTS> heads;  // First node number per slot
+    std::array<TimerNode, TIMER_CAPACITY> nodes;
+    std::uint8_t used;           // Nodes ever handed out; the rest have never been used
+    std::uint8_t freeHead;       // Released nodes, linked through next
+    std::uint8_t pending;
+
+    // Fires event(arg) delay ticks from now (at least 1, at most
+    // TIMER_MAX_DELAY). Returns 0 when all TIMER_CAPACITY timers are taken.
+    TimerId schedule(std::uint32_t delay, TimerEvent event, std::uint8_t arg = 0) {
+        int number = freeHead;
+        if (number) {
+            freeHead = nodes[number - 1].next;
+        } else if (used < TIMER_CAPACITY) {
+            number = ++used;
+        } else {
+            return 0;
+        }
+        TimerNode &node = nodes[number - 1];
+        node.due = now + (delay < 1 ? 1 : delay > TIMER_MAX_DELAY ? TIMER_MAX_DELAY : delay);
+        node.event = event;
+        node.arg = arg;
+        node.generation = (node.generation + 1) & TIMER_GENERATION_MASK;
+        link(number);
+        pending++;
+        return idFor(number);
+    }
+
+    // Returns false when the timer already fired or was cancelled
+    bool cancel(TimerId id) {
+        int number = numberOf(id);
+        if (!number) return false;
+        unlink(number);
+        release(number);
+        return true;
+    }
+
+    bool isPending(TimerId id) const { return numberOf(id) != 0; }
+
+    // Ticks until the timer fires, 0 if it is not pending
+    std::uint32_t remaining(TimerId id) const {
+        int number = numberOf(id);
+        return number ? nodes[number - 1].due - now : 0;
+    }
+
+    // Moves time on by one tick and calls fire(event, arg) for every timer
+    // that is now due. fire may schedule and cancel timers.
+    template <typename Fire>
+    void advance(Fire &&fire) {
+        now++;
+        for (int level = TIMER_LEVELS - 1; level > 0; --level) {
+            if (now & ((1u << (TIMER_SLOT_BITS * level)) - 1)) continue;
+            // The coarse slot that starts now moves down to finer slots
+            std::uint8_t &head = heads[level * TIMER_SLOTS + slotOf(level, now)];
+            int number = head;
+            head = 0;
+            while (number) {
+                int next = nodes[number - 1].next;
+                link(number);
+                number = next;
+            }
+        }
+
+        std::uint8_t &head = heads[slotOf(0, now)];
+        while (head) {
+            int number = head;
+            TimerEvent event = nodes[number - 1].event;
+            std::uint8_t arg = nodes[number - 1].arg;
+            unlink(number);
+            release(number);
+            fire(event, arg);
+        }
+    }
+
+    // Calls visit(event, arg) for every pending timer, in no particular order
+    template <typename Visit>
+    void forEachPending(Visit visit) const {
+        for (int i = 0; i < used && i < TIMER_CAPACITY; ++i) {
+            if (nodes[i].event != TimerEvent::None) visit(nodes[i].event, nodes[i].arg);
+        }
+    }
+
+    // For wheels that come from outside (level packs): every node number in
+    // range, every list well formed, each timer in a slot that advance()
+    // reaches before it is due, and the counts adding up. Scheduling,
+    // cancelling and advancing a wheel that passes stay in bounds.
+    bool isConsistent() const {
+        if (used > TIMER_CAPACITY || pending > used || freeHead > used) return false;
+        std::array<bool, TIMER_CAPACITY> seen{};
+        int scheduled = 0;
+        for (int list = 0; list < TIMER_LEVELS * TIMER_SLOTS; ++list) {
+            int level = list / TIMER_SLOTS, previous = 0;
+            for (int number = heads[list]; number; number = nodes[number - 1].next) {
+                if (number > used || seen[number - 1]) return false;
+                seen[number - 1] = true;
+                const TimerNode &node = nodes[number - 1];
+                if (node.event == TimerEvent::None || node.event > TimerEvent::GhostRespawn) return false;
+                if (node.list != list || node.prev != previous || node.generation > TIMER_GENERATION_MASK) return false;
+                if (!reachable(level, list % TIMER_SLOTS, node.due)) return false;
+                previous = number;
+                scheduled++;
+            }
+        }
+        if (scheduled != pending) return false;
+        int released = 0;
+        for (int number = freeHead; number; number = nodes[number - 1].next) {
+            if (number > used || seen[number - 1] || nodes[number - 1].event != TimerEvent::None) return false;
+            seen[number - 1] = true;
+            released++;
+        }
+        return scheduled + released == used;
+    }
+
+    bool operator==(const TimerWheel &) const = default;
+
+private:
+    // Whether a timer in this level and slot fires at due: the slot is the
+    // one due maps to, and the slot comes round (level 0) or cascades
+    // (coarser levels) after now but before the wheel wraps past due
+    bool reachable(int level, int slot, std::uint32_t due) const {
+        int shift = TIMER_SLOT_BITS * level;
+        if (due <= now || slot != slotOf(level, due)) return false;
+        if (level == 0) return due - now <= static_cast<std::uint32_t>(TIMER_SLOTS);
+        return (due >> shift) > (now >> shift) && due - now < (1u << (shift + TIMER_SLOT_BITS));
+    }
+
+    static int slotOf(int level, std::uint32_t tick) { return (tick >> (TIMER_SLOT_BITS * level)) & (TIMER_SLOTS - 1); }
+
+    TimerId idFor(int number) const { return nodes[number - 1].generation << 8 | static_cast<TimerId>(number); }
+
+    int numberOf(TimerId id) const {
+        int number = id & 0xFF;
+        if (number < 1 || number > used) return 0;
+        const TimerNode &node = nodes[number - 1];
+        return node.event != TimerEvent::None && node.generation == (id >> 8) ? number : 0;
+    }
+
+    // Into the finest level whose slots still reach the due tick
+    void link(int number) {
+        TimerNode &node = nodes[number - 1];
+        std::uint32_t delay = node.due - now;
+        int level = 0;
+        while (level + 1 < TIMER_LEVELS && delay >= (1u << (TIMER_SLOT_BITS * (level + 1)))) level++;
+        node.list = static_cast<std::uint8_t>(level * TIMER_SLOTS + slotOf(level, node.due));
+        std::uint8_t &head = heads[node.list];
+        node.prev = 0;
+        node.next = head;
+        if (head) nodes[head - 1].prev = static_cast<std::uint8_t>(number);
+        head = static_cast<std::uint8_t>(number);
+    }
+
+    void unlink(int number) {
+        TimerNode &node = nodes[number - 1];
+        if (node.prev) {
+            nodes[node.prev - 1].next = node.next;
+        } else {
+            heads[node.list] = node.next;
+        }
+        if (node.next) nodes[node.next - 1].prev = node.prev;
+    }
+
+    void release(int number) {
+        TimerNode &node = nodes[number - 1];
+        node.event = TimerEvent::None;
+        node.next = freeHead;
+        freeHead = static_cast<std::uint8_t>(number);
+        pending--;
+    }
+};
+
+static_assert(std::is_trivially_copyable<TimerWheel>::value, "TimerWheel is part of SimState and must stay memcpy-able");
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Timeline tracing in the Chrome trace-event format; the output opens in
+// ui.perfetto.dev or chrome://tracing. Every thread records into its own
+// fixed ring, so recording takes no lock and never allocates once the ring
+// exists. While tracing is off each probe is one relaxed load and a branch.
+//
+//   setTraceThreadName("renderingThread");
+//   { TraceSpan span("draw"); ... }
+//   TracedLock lock(mutex, GAME_BOARD_LOCK_TRACE);  // wait and hold spans
+//
+// Event names must be string literals (or otherwise outlive the flush).
+
+using TraceClock = std::chrono::steady_clock;
+
+struct TraceEvent {
+    const char *name;
+    std::int64_t start;     // ns since the trace epoch
+    std::int64_t duration;  // ns
+};
+
+// Single-producer ring owned by one thread. When it wraps, the oldest
+// events are overwritten and counted as dropped.
+class TraceBuffer {
+public:
+    static constexpr std::size_t CAPACITY = 1 << 16;
+
+    explicit TraceBuffer(int tid) : tid_(tid), events_(new TraceEvent[CAPACITY]) {}
+
+    void record(const char *name, std::int64_t start, std::int64_t duration) {
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        events_[head % CAPACITY] = TraceEvent{name, start, duration};
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    int tid() const { return tid_; }
+    const char *threadName() const { return threadName_.load(std::memory_order_acquire); }
+    void setThreadName(const char *name) { threadName_.store(name, std::memory_order_release); }
+
+    // Calls visit for every event recorded since the last clear() that is
+    // still in the ring, oldest first
+    template <typename Visit>
+    std::uint64_t forEach(Visit visit) const {
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        std::uint64_t cleared = cleared_.load(std::memory_order_acquire);
+        std::uint64_t oldest = head > CAPACITY ? head - CAPACITY : 0;
+        std::uint64_t first = std::max(oldest, cleared);
+        for (std::uint64_t i = first; i < head; ++i) visit(events_[i % CAPACITY]);
+        return first - cleared; // Number of dropped events
+    }
+
+    // Forgets everything recorded so far and the thread's name. The owning
+    // thread may still exist (and keep its pointer to this ring), so the
+    // ring stays and only its start moves up to the current head.
+    void clear() {
+        cleared_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+        threadName_.store(nullptr, std::memory_order_release);
+    }
+
+    bool empty() const { return head_.load(std::memory_order_acquire) == cleared_.load(std::memory_order_acquire); }
+
+private:
+    int tid_;
+    std::unique_ptr<TraceEvent[]> events_;
+    std::atomic<std::uint64_t> head_{0};
+    std::atomic<std::uint64_t> cleared_{0};  // head_ at the last clear()
+    std::atomic<const char *> threadName_{nullptr};
+};
+
+class Tracer {
+public:
+    static Tracer &instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Starts a new trace: whatever an earlier run recorded is dropped, so
+    // its events and threads do not show up with the next flush
+    void start() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto &buffer : buffers_) buffer->clear();
+        }
+        contended_.store(0, std::memory_order_relaxed);
+        epoch_ = TraceClock::now();
+        enabled_.store(true, std::memory_order_release);
+    }
+
+    void stop() { enabled_.store(false, std::memory_order_release); }
+
+    std::int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(TraceClock::now() - epoch_).count();
+    }
+
+    // The calling thread's ring, created on first use
+    TraceBuffer &threadBuffer() {
+        thread_local TraceBuffer *buffer = nullptr;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.emplace_back(new TraceBuffer(static_cast<int>(buffers_.size()) + 1));
+            buffer = buffers_.back().get();
+        }
+        return *buffer;
+    }
+
+    void countContention() { contended_.fetch_add(1, std::memory_order_relaxed); }
+
+    // Writes everything recorded so far. Threads may still be recording;
+    // events that are overwritten while the file is written can come out
+    // garbled, so flush after the traced threads have stopped.
+    bool writeJson(const std::string &path) {
+        std::FILE *file = std::fopen(path.c_str(), "w");
+        if (!file) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uint64_t events = 0, dropped = 0;
+        std::size_t threads = 0;
+        bool first = true;
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        for (const auto &buffer : buffers_) {
+            const char *threadName = buffer->threadName();
+            if (!threadName && buffer->empty()) continue;  // Not traced since start()
+            threads++;
+            if (threadName) {
+                std::fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                             first ? "" : ",\n", buffer->tid(), threadName);
+                first = false;
+            }
+            dropped += buffer->forEach([&](const TraceEvent &event) {
+                std::fprintf(file, "%s{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                             first ? "" : ",\n", event.name, buffer->tid(), event.start / 1e3, event.duration / 1e3);
+                first = false;
+                events++;
+            });
+        }
+        std::fprintf(file, "\n]}\n");
+        bool ok = std::fclose(file) == 0;
+
+        std::printf("Trace: %llu events from %zu threads, %llu dropped, %llu contended lock acquisitions -> %s\n",
+                    static_cast<unsigned long long>(events), threads, static_cast<unsigned long long>(dropped),
+                    static_cast<unsigned long long>(contended_.load()), path.c_str());
+        return ok;
+    }
+
+private:
+    Tracer() : epoch_(TraceClock::now()) {}
+
+    std::atomic<bool> enabled_{false};
+    TraceClock::time_point epoch_;
+    std::mutex mutex_; // Guards buffers_, only taken when a thread first traces and at flush
+    std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+    std::atomic<std::uint64_t> contended_{0};
+};
+
+inline bool tracingEnabled() { return Tracer::instance().enabled(); }
+
+// Names the calling thread in the timeline and creates its ring up front,
+// so the first traced event inside a hot loop does not allocate
+inline void setTraceThreadName(const char *name) {
+    if (!tracingEnabled()) return;
+    Tracer::instance().threadBuffer().setThreadName(name);
+}
+
+inline void traceComplete(const char *name, std::int64_t start, std::int64_t end) {
+    Tracer::instance().threadBuffer().record(name, start, end - start);
+}
+
+// Records the lifetime of the scope as one span
+class TraceSpan {
+public:
+    explicit TraceSpan(const char *name) : name_(name), start_(tracingEnabled() ? Tracer::instance().now() : -1) {}
+
+    ~TraceSpan() {
+        if (start_ >= 0) traceComplete(name_, start_, Tracer::instance().now());
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *name_;
+    std::int64_t start_;
+};
+
+struct LockTraceNames {
+    const char *wait;  // Blocked trying to take the lock
+    const char *hold;  // Holding it
+};
+
+// lock_guard that, while tracing, records how long it waited for the mutex
+// (only when the mutex was actually taken by someone else) and how long it
+// held it
+class TracedLock {
+public:
+    TracedLock(std::mutex &mutex, const LockTraceNames &names) : mutex_(mutex), names_(names) {
+        if (!tracingEnabled()) {
+            mutex_.lock();
+            return;
+        }
+        Tracer &tracer = Tracer::instance();
+        if (!mutex_.try_lock()) {
+            std::int64_t waitStart = tracer.now();
+            mutex_.lock();
+            traceComplete(names_.wait, waitStart, tracer.now());
+            tracer.countContention();
+        }
+        heldSince_ = tracer.now();
+    }
+
+    ~TracedLock() {
+        if (heldSince_ < 0) {
+            mutex_.unlock();
+            return;
+        }
+        std::int64_t released = Tracer::instance().now();
+        mutex_.unlock();
+        traceComplete(names_.hold, heldSince_, released);
+    }
+
+    TracedLock(const TracedLock &) = delete;
+    TracedLock &operator=(const TracedLock &) = delete;
+
+private:
+    std::mutex &mutex_;
+    const LockTraceNames &names_;
+    std::int64_t heldSince_ = -1;
+};